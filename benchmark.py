@@ -0,0 +1,149 @@
+#! /usr/bin/env python3
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+import time
+
+DEFAULT_GRIDS = '2,4,8,16,32'
+DEFAULT_OUTPUT_FOLDER = '/OUTPUT_BENCHMARK'
+DEFAULT_SIMU_END = 10000000
+DEFAULT_TOLERANCE = 0.2
+
+# Generated models: name, tasks, runnables, labels
+MODELS = [
+ ('small', 10, 100, 500),
+ ('medium', 50, 1000, 5000),
+ ('large', 200, 10000, 50000),
+]
+
+RESULTS_HEADER = 'Model,Tasks,Runnables,Labels,Rows,Cols,Status,Wall time(s),Peak RSS(KB),Activations,Events/s,Simulated ns/s'
+
+def getEnv():
+    # Add systemc lib to LD_LIBRARY_PATH
+    my_env = os.environ.copy()
+    sc_home = my_env.get('SYSTEMC_HOME', '')
+    if not sc_home:
+        raise ValueError('You must define the SYSTEMC_HOME variable to use this script')
+    for file in os.listdir(sc_home):
+        if 'lib-' in file:
+            my_env['LD_LIBRARY_PATH'] = my_env.get('LD_LIBRARY_PATH', '') + ':' + sc_home + '/' + file
+            break
+    my_env['SC_COPYRIGHT_MESSAGE'] = 'DISABLE'
+    xerces_home = my_env.get('XERCES_HOME', '')
+    if xerces_home:
+         my_env['LD_LIBRARY_PATH'] = my_env.get('LD_LIBRARY_PATH', '') + ':' + xerces_home + '/lib'
+    return my_env
+
+def readProfileValue(report, label):
+    match = re.search(r'^\s+' + re.escape(label) + r'\s*:\s*([0-9.e+]+)', report, re.MULTILINE)
+    if match:
+        return float(match.group(1))
+    return 0.0
+
+def runSimulation(binary, app, out, size, simuEnd, env):
+    if not os.path.exists(out):
+        os.makedirs(out)
+    cmd = [binary, '-a', app, '-i', '1', '-o', out, '-x', str(size), '-y', str(size), '-freq', '1000000000',
+           '-simuEnd', str(simuEnd), '-m', 'ZigZag', '-s', 'fcfs', '-policy', 'RoundRobin', '-bsize', '16',
+           '-lrc', '2', '-rrc', '2', '-lwc', '2', '-rwc', '2', '-outputs', 'none', '-waveFormat', 'none']
+    reportFile = open(out + '/OUTPUT_Execution_Report.log', 'w')
+    start = time.time()
+    sim = subprocess.Popen(cmd, stdout=reportFile, stderr=subprocess.STDOUT, env=env)
+
+    # wait4 (python 3.3+) gives the peak RSS of this simulation only
+    pid, status, usage = os.wait4(sim.pid, 0)
+    wallTime = time.time() - start
+    reportFile.close()
+    report = open(out + '/OUTPUT_Execution_Report.log').read()
+    activations = readProfileValue(report, 'Process activations')
+    simulatedNs = readProfileValue(report, 'Execution time of the application')
+    return {'status': 'ok' if status == 0 else 'failed', 'wallTime': wallTime, 'peakRss': usage.ru_maxrss,
+            'activations': int(activations), 'eventsPerSecond': activations / wallTime,
+            'simulatedNsPerSecond': simulatedNs / wallTime}
+
+def readResults(file):
+    results = {}
+    lines = open(file).read().splitlines()
+    for line in lines[1:]:
+        fields = line.split(',')
+        if len(fields) < 8:
+            continue
+        if fields[6] != 'ok':
+            print ('reference run ' + fields[0] + ' ' + fields[4] + 'x' + fields[5] + ' failed, it is not compared')
+            continue
+        results[(fields[0], fields[4], fields[5])] = float(fields[7])
+    return results
+
+def main():
+
+    # Configure parameters parser
+    parser = argparse.ArgumentParser(description='Crossbar simulator scalability benchmark')
+    parser.add_argument('-g',  '--grids', default=DEFAULT_GRIDS, help='specify the comma separated sizes of the square platforms')
+    parser.add_argument('-md', '--models', default=','.join([m[0] for m in MODELS]), help='specify the comma separated generated models to run among ' + ', '.join([m[0] for m in MODELS]))
+    parser.add_argument('-e',  '--simuEnd', type=int, default=DEFAULT_SIMU_END, help='specify the simulated time in nanosecond of each run')
+    parser.add_argument('-o',  '--output_folder', help='specify the absolute path of the benchmark folder')
+    parser.add_argument('-b',  '--binary', help='specify the simulator binary (obj/mcsim-ca-xbar by default)')
+    parser.add_argument('-ref', '--reference', help='specify a previous results file, runs slower than it by more than the tolerance are reported as regressions')
+    parser.add_argument('-tol', '--tolerance', type=float, default=DEFAULT_TOLERANCE, help='specify the tolerated wall time increase ratio')
+    parser.add_argument('-v',  '--verbose', action='store_true', help='enable verbose output')
+    args = parser.parse_args()
+
+    root = os.path.dirname(os.path.realpath(__file__))
+    out = args.output_folder if args.output_folder else root + DEFAULT_OUTPUT_FOLDER
+    if not os.path.exists(out):
+        os.makedirs(out)
+    binary = args.binary if args.binary else root + '/obj/mcsim-ca-xbar'
+    env = getEnv()
+    grids = [int(g) for g in args.grids.split(',')]
+    models = [m for m in MODELS if m[0] in args.models.split(',')]
+    reference = readResults(args.reference) if args.reference else {}
+
+    resultsFile = open(out + '/benchmark_results.csv', 'w')
+    resultsFile.write(RESULTS_HEADER + '\n')
+    regressions = []
+    failures = []
+    for name, tasks, runnables, labels in models:
+
+        # Generate the model once, with a fixed seed
+        app = out + '/' + name + '.amxmi'
+        if not os.path.exists(app):
+            cmd = [sys.executable, root + '/generate-app.py', '-o', app, '-t', str(tasks), '-r', str(runnables), '-l', str(labels)]
+            if args.verbose:
+                print (' '.join(cmd))
+            if subprocess.call(cmd) != 0:
+                print ('generation of ' + name + ' FAILED')
+                sys.exit(-1)
+        for size in grids:
+            result = runSimulation(binary, app, out + '/' + name + '_' + str(size) + 'x' + str(size), size, args.simuEnd, env)
+            line = '{m},{t},{r},{l},{x},{y},{s},{w:.3f},{rss},{a},{e:.0f},{n:.0f}'.format(m=name, t=tasks, r=runnables, l=labels,
+                x=size, y=size, s=result['status'], w=result['wallTime'], rss=result['peakRss'], a=result['activations'],
+                e=result['eventsPerSecond'], n=result['simulatedNsPerSecond'])
+            resultsFile.write(line + '\n')
+            resultsFile.flush()
+            print (line)
+            if result['status'] != 'ok':
+                failures.append('{m} {x}x{y}: see {o}'.format(m=name, x=size, y=size,
+                    o=out + '/' + name + '_' + str(size) + 'x' + str(size) + '/OUTPUT_Execution_Report.log'))
+                continue
+            key = (name, str(size), str(size))
+            if key in reference and result['wallTime'] > reference[key] * (1 + args.tolerance):
+                regressions.append('{m} {x}x{y}: {w:.3f} s instead of {r:.3f} s'.format(m=name, x=size, y=size, w=result['wallTime'], r=reference[key]))
+    resultsFile.close()
+
+    if failures:
+        print ('Failed simulations:')
+        for failure in failures:
+            print ('    ' + failure)
+    if regressions:
+        print ('Performance regressions:')
+        for regression in regressions:
+            print ('    ' + regression)
+    if failures or regressions:
+        sys.exit(1)
+
+# This script runs the main
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,183 @@
+#! /usr/bin/env python2
+
+import argparse
+import random
+
+DEFAULT_TASKS = 10
+DEFAULT_RUNNABLES = 100
+DEFAULT_LABELS = 500
+DEFAULT_LABEL_SIZES = '8,256'
+DEFAULT_PERIODS = '1000,2000,5000,10000,20000,50000,100000'
+DEFAULT_DEPENDENCY_DENSITY = 0.3
+DEFAULT_READS = 4
+DEFAULT_WRITES = 2
+DEFAULT_INSTRUCTIONS = '100,5000'
+DEFAULT_CORE_TYPES = 2
+DEFAULT_SEED = 1
+
+HEADER = '''<?xml version="1.0" encoding="UTF-8"?>
+<central:AMALTHEA xmi:version="2.0" xmlns:xmi="http://www.omg.org/XMI" xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance" xmlns:central="http://www.amalthea.itea2.org/model/1.1.0/central" xmlns:common="http://www.amalthea.itea2.org/model/1.1.0/common" xmlns:events="http://www.amalthea.itea2.org/model/1.1.0/events" xmlns:hw="http://www.amalthea.itea2.org/model/1.1.0/hw" xmlns:mapping="http://www.amalthea.itea2.org/model/1.1.0/mapping" xmlns:os="http://www.amalthea.itea2.org/model/1.1.0/os" xmlns:stimuli="http://www.amalthea.itea2.org/model/1.1.0/stimuli" xmlns:sw="http://www.amalthea.itea2.org/model/1.1.0/sw" xmi:id="_gen_root">
+'''
+
+class idGenerator:
+    def __init__(self):
+        self.count = 0
+    def next(self, kind):
+        self.count += 1
+        return '_gen_{k}_{n}'.format(k=kind, n=self.count)
+
+def parseRange(value):
+    bounds = [int(v) for v in value.split(',')]
+    if len(bounds) == 1:
+        bounds.append(bounds[0])
+    if len(bounds) != 2 or bounds[0] > bounds[1] or bounds[0] < 0:
+        raise ValueError('{s!r} is an invalid range, expected min,max'.format(s=value))
+    return bounds
+
+def generate(args):
+    rnd = random.Random(args.seed)
+    ids = idGenerator()
+    labelSizes = parseRange(args.label_sizes)
+    instructions = parseRange(args.instructions)
+    periods = [int(p) for p in args.periods.split(',')]
+    if args.tasks < 1 or args.runnables < args.tasks or args.labels < 1:
+        raise ValueError('at least one task, one runnable per task and one label are needed')
+
+    # Labels
+    labels = []
+    for l in range(args.labels):
+        labels.append({'id': ids.next('label'), 'name': 'Label_{n}'.format(n=l), 'size': rnd.randint(labelSizes[0], labelSizes[1])})
+
+    # Runnables: each one writes random labels, which may also be
+    # written by other runnables, and reads labels written by previous
+    # runnables with the dependency density probability, other reads
+    # are random labels
+    runnables = []
+    written = []
+    for r in range(args.runnables):
+        accesses = []
+        for w in range(args.writes):
+            accesses.append((rnd.randrange(len(labels)), 'write'))
+        for i in range(args.reads):
+            if written and rnd.random() < args.dependency_density:
+                accesses.append((rnd.choice(written), 'read'))
+            else:
+                accesses.append((rnd.randrange(len(labels)), 'read'))
+        rnd.shuffle(accesses)
+        written.extend([a[0] for a in accesses if a[1] == 'write'])
+        lower = rnd.randint(instructions[0], instructions[1])
+        runnables.append({'id': ids.next('runnable'), 'name': 'Runnable_{n}'.format(n=r), 'accesses': accesses,
+                          'lower': lower, 'upper': rnd.randint(lower, instructions[1])})
+
+    # Tasks: runnables are split in consecutive call sequences
+    tasks = []
+    for t in range(args.tasks):
+        first = t * args.runnables // args.tasks
+        last = (t + 1) * args.runnables // args.tasks
+        period = rnd.choice(periods)
+        tasks.append({'id': ids.next('task'), 'name': 'Task_{n}'.format(n=t), 'period': period,
+                      'priority': len(periods) - sorted(periods).index(period), 'stimulus': ids.next('stimulus'),
+                      'runnables': range(first, last)})
+
+    # Model
+    out = [HEADER]
+    out.append('  <swModel xmi:id="{i}">\n'.format(i=ids.next('swModel')))
+    for task in tasks:
+        out.append('    <tasks xmi:id="{i}" name="{n}" priority="{p}" stimuli="{s}" preemption="preemptive" multipleTaskActivationLimit="2">\n'.format(
+            i=task['id'], n=task['name'], p=task['priority'], s=task['stimulus']))
+        out.append('      <deadline xmi:id="{i}" value="{v}" unit="us"/>\n'.format(i=ids.next('deadline'), v=task['period']))
+        out.append('      <callGraph xmi:id="{i}">\n'.format(i=ids.next('callGraph')))
+        out.append('        <graphEntries xsi:type="sw:CallSequence" xmi:id="{i}" name="CS_{n}">\n'.format(i=ids.next('sequence'), n=task['name']))
+        for r in task['runnables']:
+            out.append('          <calls xsi:type="sw:TaskRunnableCall" xmi:id="{i}" runnable="{r}"/>\n'.format(i=ids.next('call'), r=runnables[r]['id']))
+        out.append('        </graphEntries>\n')
+        out.append('      </callGraph>\n')
+        out.append('    </tasks>\n')
+    for runnable in runnables:
+        out.append('    <runnables xmi:id="{i}" name="{n}">\n'.format(i=runnable['id'], n=runnable['name']))
+        out.append('      <size xmi:id="{i}" numberBits="{b}"/>\n'.format(i=ids.next('size'), b=8 * (runnable['upper'] + 1)))
+        for label, access in runnable['accesses']:
+            out.append('      <runnableItems xsi:type="sw:LabelAccess" xmi:id="{i}" data="{d}"{a}>\n'.format(
+                i=ids.next('access'), d=labels[label]['id'], a=' access="write"' if access == 'write' else ''))
+            out.append('        <statistic xmi:id="{i}">\n'.format(i=ids.next('statistic')))
+            out.append('          <{a} xsi:type="common:SingleValueStatistic" xmi:id="{i}" value="1.0"/>\n'.format(a=access, i=ids.next('value')))
+            out.append('        </statistic>\n')
+            out.append('      </runnableItems>\n')
+        out.append('      <runnableItems xsi:type="sw:InstructionsDeviation" xmi:id="{i}">\n'.format(i=ids.next('instructions')))
+        out.append('        <deviation xmi:id="{i}">\n'.format(i=ids.next('deviation')))
+        out.append('          <lowerBound xsi:type="common:LongObject" xmi:id="{i}" value="{v}"/>\n'.format(i=ids.next('bound'), v=runnable['lower']))
+        out.append('          <upperBound xsi:type="common:LongObject" xmi:id="{i}" value="{v}"/>\n'.format(i=ids.next('bound'), v=runnable['upper']))
+        out.append('        </deviation>\n')
+        out.append('      </runnableItems>\n')
+        out.append('    </runnables>\n')
+    for label in labels:
+        out.append('    <labels xmi:id="{i}" name="{n}">\n'.format(i=label['id'], n=label['name']))
+        out.append('      <size xmi:id="{i}" numberBits="{b}"/>\n'.format(i=ids.next('size'), b=label['size']))
+        out.append('    </labels>\n')
+    out.append('  </swModel>\n')
+
+    # Hardware: core types and one core and scheduler per core type
+    cores = []
+    out.append('  <hwModel xmi:id="{i}">\n'.format(i=ids.next('hwModel')))
+    for c in range(args.core_types):
+        cores.append({'type': ids.next('coreType'), 'core': ids.next('core'), 'scheduler': ids.next('scheduler')})
+        out.append('    <coreTypes xmi:id="{i}" name="Core_{n}" instructionsPerCycle="{p}"/>\n'.format(i=cores[c]['type'], n=c, p=1 + c % 4))
+    out.append('    <system xmi:id="{i}" name="Generated_System">\n'.format(i=ids.next('system')))
+    out.append('      <ecus xmi:id="{i}" name="Generated_ECU">\n'.format(i=ids.next('ecu')))
+    out.append('        <microcontrollers xmi:id="{i}" name="Generated_Microcontroller">\n'.format(i=ids.next('microcontroller')))
+    for c in range(args.core_types):
+        out.append('          <cores xmi:id="{i}" name="Core_{n}" coreType="{t}"/>\n'.format(i=cores[c]['core'], n=c, t=cores[c]['type']))
+    out.append('        </microcontrollers>\n')
+    out.append('      </ecus>\n')
+    out.append('    </system>\n')
+    out.append('  </hwModel>\n')
+    out.append('  <osModel xmi:id="{i}">\n'.format(i=ids.next('osModel')))
+    for c in range(args.core_types):
+        out.append('    <scheduler xmi:id="{i}" name="Sched_{n}">\n'.format(i=cores[c]['scheduler'], n=c))
+        out.append('      <schedulingAlgorithm xsi:type="os:OSEK" xmi:id="{i}"/>\n'.format(i=ids.next('algorithm')))
+        out.append('    </scheduler>\n')
+    out.append('  </osModel>\n')
+
+    # Periodic stimuli of the tasks
+    out.append('  <stimuliModel xmi:id="{i}">\n'.format(i=ids.next('stimuliModel')))
+    for task in tasks:
+        out.append('    <stimuli xsi:type="stimuli:Periodic" xmi:id="{i}" name="Stimuli_{n}">\n'.format(i=task['stimulus'], n=task['name']))
+        out.append('      <offset xmi:id="{i}" unit="us"/>\n'.format(i=ids.next('offset')))
+        out.append('      <recurrence xmi:id="{i}" value="{v}" unit="us"/>\n'.format(i=ids.next('recurrence'), v=task['period']))
+        out.append('    </stimuli>\n')
+    out.append('  </stimuliModel>\n')
+    out.append('  <mappingModel xmi:id="{i}">\n'.format(i=ids.next('mappingModel')))
+    for t in range(len(tasks)):
+        out.append('    <executableAllocation xsi:type="mapping:ProcessAllocation" xmi:id="{i}" scheduler="{s}" process="{p}"/>\n'.format(
+            i=ids.next('allocation'), s=cores[t % len(cores)]['scheduler'], p=tasks[t]['id']))
+    for core in cores:
+        out.append('    <coreAllocation xmi:id="{i}" scheduler="{s}" core="{c}"/>\n'.format(i=ids.next('allocation'), s=core['scheduler'], c=core['core']))
+    out.append('  </mappingModel>\n')
+    out.append('</central:AMALTHEA>\n')
+
+    f = open(args.output, 'w')
+    f.write(''.join(out))
+    f.close()
+
+def main():
+
+    # Configure parameters parser
+    parser = argparse.ArgumentParser(description='Synthetic AMALTHEA application generator')
+    parser.add_argument('-o',  '--output', required=True, help='specify the generated amxmi file')
+    parser.add_argument('-t',  '--tasks', type=int, default=DEFAULT_TASKS, help='specify the number of periodic tasks')
+    parser.add_argument('-r',  '--runnables', type=int, default=DEFAULT_RUNNABLES, help='specify the number of runnables, split among the tasks')
+    parser.add_argument('-l',  '--labels', type=int, default=DEFAULT_LABELS, help='specify the number of labels')
+    parser.add_argument('-ls', '--label_sizes', default=DEFAULT_LABEL_SIZES, help='specify the min,max size of labels in bits')
+    parser.add_argument('-p',  '--periods', default=DEFAULT_PERIODS, help='specify the comma separated periods in microsecond the tasks periods are drawn from')
+    parser.add_argument('-dd', '--dependency_density', type=float, default=DEFAULT_DEPENDENCY_DENSITY, help='specify the probability that a label read depends on a previous runnable')
+    parser.add_argument('-rd', '--reads', type=int, default=DEFAULT_READS, help='specify the number of label reads per runnable')
+    parser.add_argument('-wr', '--writes', type=int, default=DEFAULT_WRITES, help='specify the number of label writes per runnable')
+    parser.add_argument('-in', '--instructions', default=DEFAULT_INSTRUCTIONS, help='specify the min,max number of instructions per runnable')
+    parser.add_argument('-ct', '--core_types', type=int, default=DEFAULT_CORE_TYPES, help='specify the number of core types')
+    parser.add_argument('-s',  '--seed', type=int, default=DEFAULT_SEED, help='specify the random seed')
+    args = parser.parse_args()
+    generate(args)
+
+# This script runs the main
+if __name__ == "__main__":
+    main()
@@ -78,19 +78,52 @@ def main():
     ''' Run the abstract simulator '''
     # Configure parameters parser
     parser = argparse.ArgumentParser(description='Crossbar simulator runner script')
+    parser.add_argument('-cs', '--cacheSize', type=int, help='specify the size in bytes of the label cache of each core (0 to disable)')
+    parser.add_argument('-cw', '--cacheWays', type=int, help='specify the associativity of the label caches')
+    parser.add_argument('-cc', '--cacheCoherence', help='specify the label caches coherence policy (write-invalidate or write-update)', choices=['inv', 'upd'])
     parser.add_argument('-d', '--syntax_dependency', action='store_true', help='consider successive runnables in tasks call graph as dependent')
+    parser.add_argument('-dvfs', '--dvfs_governor', help='enable DVFS with the given governor', choices=['fixed', 'ondemand', 'slack'])
+    parser.add_argument('-dvfst', '--dvfs_table', help='specify a file giving the DVFS operating points (frequencyInHz,voltage per line)')
+    parser.add_argument('-dvfsp', '--dvfsPeriod', type=int, help='specify the DVFS governor period in nanosecond')
+    parser.add_argument('-dvfsl', '--dvfsLatency', type=int, help='specify the duration in nanosecond of a frequency transition')
     appGroup = parser.add_mutually_exclusive_group()
     appGroup.add_argument('-da', '--def_application', help='specify the application to be simulated among the default ones', choices=['DC'])
     appGroup.add_argument('-ca', '--custom_application', help='specify a custom application file to be simulated')
     parser.add_argument('-e', '--simuEnd', help='specify the end time of simulation in nanosecond', type=int)
     parser.add_argument('-f', '--freq', help='specify the frequency of all the cores in the platform (i.g 400MHz or 1GHz)', action=ValidateFreq)
     appGroup.add_argument('-mf', '--modes_file', help='specify a modes switching file to be simulated')
+    parser.add_argument('-mc', '--modes_cache', help='specify a folder where the instruction deltas of the modes are cached for the next runs on the same files (the application itself is still parsed)')
+    parser.add_argument('-il', '--instructions_log', action='store_true', help='also log every executed instruction in Instruction_fixed_Power.txt (can be huge)')
+    parser.add_argument('-is', '--instructions_summary', help='specify the format of the executed instructions summary used for energy estimation', choices=['csv', 'bin'])
     parser.add_argument('-i', '--iterations', type=int, help='specify the number of application to execute (has no effect with -p)')
+    parser.add_argument('-mshr', '--mshr', type=int, help='specify the number of remote reads each core can issue ahead of use (0 for blocking reads)')
     parser.add_argument('-m', '--mapping_strategy', help='specify the mapping strategy used to map runnables on cores. Valide strategies are ' + str(MAPPINGS), nargs="+",  action=ValidateMapping)
     parser.add_argument('-np', '--no_periodicity', action='store_true', help='run periodic runnables only once')
     parser.add_argument('-o', '--output_folder', help='specify the absolute path of the output folder where simulation results will be generated')
+    parser.add_argument('-out', '--outputs', help='specify the comma separated list of output files to write among mapping, runnables_csv, runnables_arff, noc_csv, noc_arff, packet_trace, graphs and labels, or all (but packet_trace) or none (energy estimation is skipped without noc_csv)')
+    parser.add_argument('-pf', '--platform_file', help='specify a platform file giving the core type, frequency and clock domain of each core')
     parser.add_argument('-r', '--random', action='store_true', help='replace constant seed used to generate instructions timing distributions by a random one based on the time')
     parser.add_argument('-s', '--scheduling_strategy', help='specify the scheduling strategy used by cores to choose the runnable to execute', choices=['fcfs', 'prio'])
+    parser.add_argument('-wcb', '--writeCombiningWindow', type=int, help='specify the window in nanosecond during which remote writes to the same core are combined (0 to disable)')
+    parser.add_argument('-wf', '--waveform_format', help='specify the format of the cores waveform (none to disable it)', choices=['vcd', 'bin', 'none'])
+    parser.add_argument('-ws', '--waveform_start', type=int, help='specify the time in nanosecond from which the waveform is captured')
+    parser.add_argument('-we', '--waveform_end', type=int, help='specify the time in nanosecond until which the waveform is captured')
+    parser.add_argument('-ckt', '--checkpoint_time', type=int, help='save a checkpoint of the simulation at the given time in nanosecond')
+    parser.add_argument('-ckm', '--checkpoint_mode', help='save a checkpoint of the simulation when switching to the given mode')
+    parser.add_argument('-rs', '--restore', help='resume the simulation from the given checkpoint file')
+    parser.add_argument('-pg', '--progress', type=int, help='print the simulation progress every given number of seconds')
+    parser.add_argument('-pr', '--profile', action='store_true', help='print the profile of the simulation so far when receiving SIGUSR1 (also enabled by -pg)')
+    parser.add_argument('-tp', '--traffic', help='characterize the cross bar with the given synthetic traffic pattern instead of simulating the application', choices=['uniform', 'hotspot', 'transpose', 'bitcomp', 'bursty'])
+    parser.add_argument('-ir', '--injection_rates', help='specify the comma separated injection rates in packets per cycle per core of the traffic characterization')
+    parser.add_argument('-tw', '--traffic_window', type=int, help='specify the measurement window in cycles of each injection rate')
+    parser.add_argument('-rp', '--replay', help='replay the given packet trace through the cross bar instead of simulating the application')
+    parser.add_argument('-cl', '--closed_loop', action='store_true', help='replay the packet trace keeping the recorded gaps between dependent packets instead of the recorded times')
+    parser.add_argument('-hp', '--hyperperiods', type=int, help='cover the given number of hyperperiods, simulating only the sampled ones in detail')
+    parser.add_argument('-sp', '--samples', type=int, help='specify the number of hyperperiods simulated in detail out of the covered ones')
+    parser.add_argument('-fi', '--fidelity', help='simulate the cross bar cycle-accurately, with a functional model, or with the functional model outside of the cycle-accurate windows', choices=['accurate', 'functional', 'hybrid'])
+    parser.add_argument('-aw', '--accurate_windows', help='specify the comma separated start:end windows in nanosecond in which the cross bar is cycle-accurate')
+    parser.add_argument('-am', '--accurate_modes', help='simulate the cross bar cycle-accurately from before to after nanoseconds around each mode switch, given as before:after')
+    parser.add_argument('-ama', '--accurate_after_miss', type=int, help='simulate the cross bar cycle-accurately during the given nanoseconds after each deadline miss')
     parser.add_argument('-v', '--verbose', action='store_true', help='enable verbose output')
     parser.add_argument('-x', '--rows', type=int, help='specify the number of rows in the platform')
     parser.add_argument('-xbp', '--xbarPolicy', help='specify the cross bar arbitration plociy', choices=['Full', 'RoundRobin', 'Priority'])
@@ -186,6 +219,8 @@ def main():
                 '-rwc', str(xbarRemoteWriteLatency)))
     if args.modes_file:
         cmd.extend(('-f', args.modes_file))
+        if args.modes_cache:
+            cmd.extend(('-modeCache', args.modes_cache))
     else:
         cmd.extend(('-a', app))
     if args.syntax_dependency:
@@ -194,26 +229,124 @@ def main():
          cmd.append('-np')
     if args.random:
          cmd.append('-r')
+    if args.instructions_log:
+         cmd.append('-instLog')
+    if args.instructions_summary:
+        cmd.append('-instSummary')
+        cmd.append(args.instructions_summary)
     if args.simuEnd:
         cmd.append('-simuEnd')
         cmd.append(str(args.simuEnd))
+    if args.platform_file:
+        cmd.append('-platform')
+        cmd.append(args.platform_file)
+    if args.mshr:
+        cmd.append('-mshr')
+        cmd.append(str(args.mshr))
+    if args.writeCombiningWindow:
+        cmd.append('-wcb')
+        cmd.append(str(args.writeCombiningWindow))
+    if args.cacheSize:
+        cmd.append('-cacheSize')
+        cmd.append(str(args.cacheSize))
+    if args.cacheWays:
+        cmd.append('-cacheWays')
+        cmd.append(str(args.cacheWays))
+    if args.cacheCoherence:
+        cmd.append('-cacheCoherence')
+        cmd.append(args.cacheCoherence)
+    if args.dvfs_governor:
+        cmd.append('-dvfs')
+        cmd.append(args.dvfs_governor)
+    if args.dvfs_table:
+        cmd.append('-dvfsTable')
+        cmd.append(args.dvfs_table)
+    if args.dvfsPeriod:
+        cmd.append('-dvfsPeriod')
+        cmd.append(str(args.dvfsPeriod))
+    if args.dvfsLatency is not None:
+        cmd.append('-dvfsLatency')
+        cmd.append(str(args.dvfsLatency))
+    if args.outputs:
+        cmd.append('-outputs')
+        cmd.append(args.outputs)
+    if args.waveform_format:
+        cmd.append('-waveFormat')
+        cmd.append(args.waveform_format)
+    if args.waveform_start:
+        cmd.append('-waveStart')
+        cmd.append(str(args.waveform_start))
+    if args.waveform_end:
+        cmd.append('-waveEnd')
+        cmd.append(str(args.waveform_end))
+    if args.checkpoint_time:
+        cmd.append('-checkpointAt')
+        cmd.append(str(args.checkpoint_time))
+    if args.checkpoint_mode:
+        cmd.append('-checkpointAtMode')
+        cmd.append(args.checkpoint_mode)
+    if args.restore:
+        cmd.append('-restore')
+        cmd.append(os.path.abspath(args.restore))
+    if args.progress:
+        cmd.append('-progress')
+        cmd.append(str(args.progress))
+    if args.profile:
+        cmd.append('-profile')
+    if args.traffic:
+        cmd.append('-traffic')
+        cmd.append(args.traffic)
+    if args.injection_rates:
+        cmd.append('-injectionRates')
+        cmd.append(args.injection_rates)
+    if args.traffic_window:
+        cmd.append('-trafficWindow')
+        cmd.append(str(args.traffic_window))
+    if args.replay:
+        cmd.append('-replay')
+        cmd.append(os.path.abspath(args.replay))
+    if args.closed_loop:
+        cmd.append('-closedLoop')
+    if args.hyperperiods:
+        cmd.append('-hyperperiods')
+        cmd.append(str(args.hyperperiods))
+    if args.samples:
+        cmd.append('-samples')
+        cmd.append(str(args.samples))
+    if args.fidelity:
+        cmd.append('-fidelity')
+        cmd.append(args.fidelity)
+    if args.accurate_windows:
+        cmd.append('-accurateWindows')
+        cmd.append(args.accurate_windows)
+    if args.accurate_modes:
+        cmd.append('-accurateModes')
+        cmd.append(args.accurate_modes)
+    if args.accurate_after_miss:
+        cmd.append('-accurateAfterMiss')
+        cmd.append(str(args.accurate_after_miss))
     cmdStr = ''
     for c in cmd:
         cmdStr = cmdStr + c + ' '
     if args.verbose:
         print cmdStr
-    sim = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.PIPE, env=my_env)
+    # Progress lines are written on the error output, let them through
+    errPipe = None if args.progress or args.profile else subprocess.PIPE
+    sim = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=errPipe, env=my_env)
     stdout, stderr = sim.communicate()
     print stdout,
     outFile = open(out + '/' + 'OUTPUT_Execution_Report.log', 'w')
     outFile.write(stdout)
     outFile.close()
     if sim.returncode != 0:
-        print stderr,
+        if stderr:
+            print stderr,
         print ('simulation FAILED')
         sys.exit(-1)
 
-    # Run the energy estimator module
+    # Run the energy estimator module, it needs the NoC traces
+    if args.traffic or args.replay or args.outputs and args.outputs != 'all' and 'noc_csv' not in args.outputs.split(','):
+        return
     cmd = [os.path.dirname(os.path.realpath(__file__)) + '/obj/energy_estimator', out, os.path.dirname(os.path.realpath(__file__)) + '/src/energy_estimator/']
     if args.verbose:
         print cmd
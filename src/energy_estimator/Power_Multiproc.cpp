@@ -73,6 +73,57 @@ float get_Energy_Instruction(struct cpu **library, int lib, int Inst_length,int
   return (((Inst_length)/(clock*1E+9))*Power_dynamic);
 }
 
+//Open the summary of executed instructions written by the simulator (Instruction_Summary.csv or Instruction_Summary.bin)
+//and skip its header. Return NULL if the simulator did not write any summary.
+FILE *Open_Instruction_Summary(std::string inputFolder, int *binary)
+{
+  char line[500];
+  char magic[4];
+  unsigned int version;
+  FILE *fp = fopen((inputFolder + "/Instruction_Summary.csv").c_str(), "r");
+  if(fp != NULL)
+    {
+      *binary = 0;
+      fgets(line, 500, fp);
+      return fp;
+    }
+  fp = fopen((inputFolder + "/Instruction_Summary.bin").c_str(), "rb");
+  if(fp != NULL)
+    {
+      *binary = 1;
+      if(fread(magic, 1, 4, fp) != 4 || strncmp(magic, "DCIS", 4) != 0 || fread(&version, sizeof(version), 1, fp) != 1)
+	{
+	  fprintf(stderr, "Instruction_Summary.bin is not a valid summary\n");
+	  fclose(fp);
+	  return NULL;
+	}
+    }
+  return fp;
+}
+
+//Read the next entry (runnable, number of executions, number of instructions) of the summary of executed instructions.
+//Return 0 at the end of the summary.
+int Read_Instruction_Summary(FILE *fp, int binary, char *Runnable_name, int max_size, long *Nb_executions, long *Nb_instructions)
+{
+  char line[500];
+  unsigned int header[4];
+  unsigned long long values[2];
+  if(!binary)
+    {
+      if(fgets(line, 500, fp) == NULL)
+	return 0;
+      return sscanf(line, "%*[^,],%199[^,],%*d,%ld,%ld", Runnable_name, Nb_executions, Nb_instructions) == 3;
+    }
+  if(fread(header, sizeof(unsigned int), 4, fp) != 4 || header[3] >= (unsigned int)max_size)
+    return 0;
+  if(fread(Runnable_name, 1, header[3], fp) != header[3] || fread(values, sizeof(unsigned long long), 2, fp) != 2)
+    return 0;
+  Runnable_name[header[3]] = '\0';
+  *Nb_executions = values[0];
+  *Nb_instructions = values[1];
+  return 1;
+}
+
 //Initialise a vector of runnables
 struct runnable *initialise_Runnables(int Nb_runnables)
 {
@@ -856,12 +907,41 @@ int main(int argc, char** argv)
   //*************************************************************************************************************//
 
   // Read Instruction Lengths 
+  // from the summary of executed instructions if the simulator wrote one,
+  // else from the raw log of executed instructions
+  int inst_count=0;
+  int summary_binary = 0;
+  long Nb_summary_executions = 0;
+  long Nb_summary_instructions = 0;
+  long k = 0;
+  FILE *summary = Open_Instruction_Summary(inputFolder, &summary_binary);
+  int from_summary = (summary != NULL);
+  if(from_summary)
+    {
+      while(Read_Instruction_Summary(summary, summary_binary, Runnable_name, max_size_runnable_name, &Nb_summary_executions, &Nb_summary_instructions))
+	{
+	  // Same computation as for the raw log, the instructions being spread over the executions
+	  for(k=0;k<Nb_summary_executions;k++)
+	    {
+	      Ins_length = Nb_summary_instructions/Nb_summary_executions + (k < Nb_summary_instructions%Nb_summary_executions ? 1 : 0);
+	      Inst_complex = Select_complexity_inst(inst_complex_min,inst_complex_max);
+	      Tot_energy_exec = Tot_energy_exec + get_Energy_Instruction(library,lib,Ins_length,Inst_complex,clk); //Dynamic-energy J
+	      Complexity_mean = Complexity_mean + (float)Inst_complex;
+	    }
+	  inst_count = inst_count + Nb_summary_executions;
+	  Time_ins = Time_ins + Nb_summary_instructions;
+	  Runn_idx = Get_Runnable_idx(Runnables_Name_Idx,Runnable_name);
+	  packets = packets + Run_Idx[Runn_idx].Nb_packets*Nb_summary_executions;
+	}
+      fclose(summary);
+    }
+  else
+    {
   fp = fopen((inputFolder + "/Instruction_fixed_Power.txt").c_str(), "r");
   if(fp == NULL) {
     perror((inputFolder + "/Instruction_fixed_Power.txt not found").c_str());
     return(-1);
   }
-  int inst_count=0;
   // Read the size of an instruction and compute the energy consumed
   while(fgets (line, size_line, fp)!=NULL)
     {
@@ -877,6 +957,7 @@ int main(int argc, char** argv)
       Time_ins = Time_ins+Ins_length;
     }
   fclose(fp);
+    }
   Complexity_mean= Complexity_mean/inst_count;
   Power_dynamic_mean = ((library[lib]->table_complex_pow)[(int)(Complexity_mean)-1]);;
   // Compute total number of messages (local or remote) and compute the energy consumed 
@@ -904,6 +985,8 @@ int main(int argc, char** argv)
 
   // Determine the theoretical number of packets
   // Go through the list of all recorded executed Runnables and determine the theoretical total number of packets
+  if(!from_summary)
+    {
   fp = fopen((inputFolder + "/Instruction_fixed_Power.txt").c_str() , "r");
   if(fp == NULL) {
     perror("Instruction_fixed_Power.txt not found in the specified directory");
@@ -919,6 +1002,7 @@ int main(int argc, char** argv)
       packets = packets + Run_Idx[Runn_idx].Nb_packets;
 
     }
+    }
   total_flits = packets*N_flt_pack;//Use label set (local or remote)
   remote_flits = N_mesg*N_flt_pack; //Additionally use RB and SB 
     
@@ -0,0 +1,32 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//                           DREAMCLOUD PROJECT                               //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////
+//    INCLUDES    //
+////////////////////
+#include "checkpoint.hxx"
+#include <cstdlib>
+
+namespace dreamcloud {
+namespace platform_sclib {
+
+void readCheckpointKey(std::istream &is, const std::string &key) {
+	std::string read;
+	if (!(is >> read) || read != key) {
+		std::cerr << "invalid checkpoint: expected " << key << " but got "
+				<< (is ? read : "end of file") << std::endl;
+		exit(-1);
+	}
+}
+
+}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  END OF FILE.                                                              //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,35 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//                           DREAMCLOUD PROJECT                               //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DREAMCLOUD__PLATFORM_SCLIB__CHECKPOINT_HXX
+#define DREAMCLOUD__PLATFORM_SCLIB__CHECKPOINT_HXX
+
+////////////////////
+//    INCLUDES    //
+////////////////////
+#include <string>
+#include <iostream>
+
+namespace dreamcloud {
+namespace platform_sclib {
+
+// Checkpoints are text files made of "key values..." records, written
+// by dcSystem::saveCheckpoint and processingElement::saveState
+const unsigned int CHECKPOINT_VERSION = 2;
+
+// Read the next key of a checkpoint and exit if it is not the given one
+void readCheckpointKey(std::istream &is, const std::string &key);
+
+}
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  END OF FILE.                                                              //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
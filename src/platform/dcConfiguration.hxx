@@ -7,3 +7,22 @@
 
 // Number of bytes in a packet (considering a given flit size in bits, this also define the number of flits)
 #define PACKET_SIZE_IN_BYTES 32
+
+// Initial capacity of the ready and blocked runnables lists of each PE
+#define RUNNABLES_LISTS_INITIAL_CAPACITY 64
+
+// Wall clock time between two checks of the progress and snapshot requests
+#define PROFILER_POLL_PERIOD_IN_MILLI 100
+
+// Share of the hotspot traffic pattern packets sent to the central core
+#define TRAFFIC_HOTSPOT_FRACTION 0.2
+
+// Mean number of packets of a burst of the bursty traffic pattern
+#define TRAFFIC_MEAN_BURST_LENGTH 8
+
+// Synthetic packets priorities are drawn in [1, TRAFFIC_PRIORITY_LEVELS]
+#define TRAFFIC_PRIORITY_LEVELS 8
+
+// Latency of the functional XBAR model, the zero-load latency of the
+// cycle-accurate one
+#define FUNCTIONAL_XBAR_LATENCY_IN_CYCLES 1
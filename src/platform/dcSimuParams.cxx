@@ -2,6 +2,7 @@
 #include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <stdexcept>
@@ -21,7 +22,7 @@ bool cmdOptionExists(char** begin, char** end, const std::string& option) {
 
 void dcSimuParams::printHelp() {
 	std::cerr << "usage is:" << std::endl << binary
-			<< " [-d] [-fd] [-h] [-np] [-r] \n"
+			<< " [-d] [-fd] [-h] [-np] [-r] [-instLog] \n"
 					"(-a app_file | -f mode_file)\n"
 					"-freq freq_in_hertz\n"
 			        "-simuEnd simu_end_in_nano\n"
@@ -31,11 +32,48 @@ void dcSimuParams::printHelp() {
 					"-rrc remote read cost \n"
 					"-lwc local write cost \n"
 					"-rwc remote write cost \n"
+					"-mshr nb_outstanding_remote_reads_per_core\n"
+					"-wcb write_combining_window_in_nano\n"
+					"-cacheSize label_cache_size_in_bytes\n"
+					"-cacheWays label_cache_associativity\n"
+					"-cacheCoherence (inv | upd)\n"
+					"-platform platform_file\n"
+					"-instSummary (csv | bin)\n"
+					"-dvfs (fixed | ondemand | slack)\n"
+					"-dvfsTable operating_points_file\n"
+					"-dvfsPeriod governor_period_in_nano\n"
+					"-dvfsLatency frequency_transition_in_nano\n"
+					"-modeCache mode_deltas_cache_folder (with -f only)\n"
+					"-outputs (all | none | output[,output...])\n"
+					"-waveFormat (vcd | bin | none)\n"
+					"-waveStart capture_start_in_nano\n"
+					"-waveEnd capture_end_in_nano\n"
+					"-checkpointAt checkpoint_time_in_nano\n"
+					"-checkpointAtMode mode_name\n"
+					"-restore checkpoint_file\n"
+					"-jobs nb_sweep_workers\n"
+					"-progress progress_period_in_seconds\n"
+					"-profile\n"
+					"-traffic (uniform | hotspot | transpose | bitcomp | bursty)\n"
+					"-injectionRates rate[,rate...]\n"
+					"-trafficWindow measurement_cycles\n"
+					"-replay packet_trace_file\n"
+					"-closedLoop\n"
+					"-hyperperiods nb_covered_hyperperiods\n"
+					"-samples nb_detailed_hyperperiods\n"
+					"-fidelity (accurate | functional | hybrid)\n"
+					"-accurateWindows start_in_nano:end_in_nano[,start:end...]\n"
+					"-accurateModes before_in_nano:after_in_nano\n"
+					"-accurateAfterMiss duration_in_nano\n"
 					"-i iterations\n"
 					"-m mapping_heuristic\n"
 					"-o output_folder\n"
 					"-s scheduling_strategy\n"
-					"-x rows -y cols" << std::endl;
+					"-x rows -y cols" << std::endl
+			<< "-a, -f, -i, -m and -s are not needed with -traffic or -replay"
+			<< std::endl
+			<< "comma separated values of -policy, -bsize, -lrc, -rrc, -lwc,\n"
+					"-rwc, -m and -freq run a parameter sweep" << std::endl;
 }
 
 bool dcSimuParams::getHelp() {
@@ -47,7 +85,19 @@ bool dcSimuParams::getSeqDep() {
 }
 
 bool dcSimuParams::getGenerateWaveforms() {
-	return true;
+	return waveformFormat != "none";
+}
+
+std::string dcSimuParams::getWaveformFormat() {
+	return waveformFormat;
+}
+
+unsigned long int dcSimuParams::getWaveformStart() {
+	return waveformStart;
+}
+
+unsigned long int dcSimuParams::getWaveformEnd() {
+	return waveformEnd;
 }
 
 bool dcSimuParams::dontHandlePeriodic() {
@@ -62,6 +112,14 @@ bool dcSimuParams::getRandomNonDet() {
 	return randomNonDet;
 }
 
+bool dcSimuParams::getInstructionsLog() {
+	return instructionsLog;
+}
+
+std::string dcSimuParams::getInstructionsSummaryFormat() {
+	return instructionsSummaryFormat;
+}
+
 std::string dcSimuParams::getOutputFolder() {
 	return outputFolder;
 }
@@ -97,6 +155,10 @@ std::string dcSimuParams::getModeFile() {
 	return modeFile;
 }
 
+std::string dcSimuParams::getPlatformFile() {
+	return platformFile;
+}
+
 unsigned int dcSimuParams::getRows() {
 	return rows;
 }
@@ -137,6 +199,126 @@ unsigned int dcSimuParams::getRemoteReadCost() {
 	return remoteReadCost;
 }
 
+unsigned int dcSimuParams::getNbMshrs() {
+	return nbMshrs;
+}
+
+unsigned long int dcSimuParams::getWriteCombiningWindow() {
+	return writeCombiningWindow;
+}
+
+unsigned long int dcSimuParams::getLabelCacheSize() {
+	return labelCacheSize;
+}
+
+unsigned int dcSimuParams::getLabelCacheWays() {
+	return labelCacheWays;
+}
+
+std::string dcSimuParams::getLabelCacheCoherence() {
+	return labelCacheCoherence;
+}
+
+std::string dcSimuParams::getDvfsGovernor() {
+	return dvfsGovernor;
+}
+
+std::string dcSimuParams::getDvfsTableFile() {
+	return dvfsTableFile;
+}
+
+unsigned long int dcSimuParams::getDvfsPeriod() {
+	return dvfsPeriod;
+}
+
+unsigned long int dcSimuParams::getDvfsLatency() {
+	return dvfsLatency;
+}
+
+std::string dcSimuParams::getModeCacheFolder() {
+	return modeCacheFolder;
+}
+
+unsigned long int dcSimuParams::getCheckpointTime() {
+	return checkpointTime;
+}
+
+std::string dcSimuParams::getCheckpointMode() {
+	return checkpointMode;
+}
+
+std::string dcSimuParams::getRestoreFile() {
+	return restoreFile;
+}
+
+unsigned int dcSimuParams::getProgressPeriod() {
+	return progressPeriod;
+}
+
+bool dcSimuParams::getProfile() {
+	return profile;
+}
+
+std::string dcSimuParams::getTrafficPattern() {
+	return trafficPattern;
+}
+
+std::vector<double> dcSimuParams::getInjectionRates() {
+	return injectionRates;
+}
+
+unsigned long int dcSimuParams::getTrafficWindow() {
+	return trafficWindow;
+}
+
+std::string dcSimuParams::getReplayFile() {
+	return replayFile;
+}
+
+bool dcSimuParams::getClosedLoop() {
+	return closedLoop;
+}
+
+unsigned long int dcSimuParams::getNbHyperperiods() {
+	return nbHyperperiods;
+}
+
+unsigned long int dcSimuParams::getNbSampledHyperperiods() {
+	return nbSampledHyperperiods;
+}
+
+std::string dcSimuParams::getXbarFidelity() {
+	return xbarFidelity;
+}
+
+std::vector<std::pair<unsigned long int, unsigned long int> > dcSimuParams::getAccurateWindows() {
+	return accurateWindows;
+}
+
+bool dcSimuParams::getAccurateAroundModes() {
+	return accurateAroundModes;
+}
+
+unsigned long int dcSimuParams::getAccurateBeforeMode() {
+	return accurateBeforeMode;
+}
+
+unsigned long int dcSimuParams::getAccurateAfterMode() {
+	return accurateAfterMode;
+}
+
+unsigned long int dcSimuParams::getAccurateAfterMiss() {
+	return accurateAfterMiss;
+}
+
+std::vector<std::string> dcSimuParams::getOutputs() {
+	return outputs;
+}
+
+bool dcSimuParams::isOutputEnabled(std::string name) {
+	return std::find(outputs.begin(), outputs.end(), name) != outputs.end();
+}
+
 double dcSimuParams::getCoresPeriodInNano() const {
 	double period = 1E9 / (double) coresFrequencyInHz;
 	return period;
@@ -175,6 +357,25 @@ dcSimuParams::dcSimuParams(int argc, char **argv) {
 		randomNonDet = false;
 	}
 
+	if (cmdOptionExists(argv, argv + argc, "-instLog")) {
+		instructionsLog = true;
+	} else {
+		instructionsLog = false;
+	}
+
+	instructionsSummaryFormat = getCmdOption(argv, argv + argc,
+			"-instSummary");
+	if (instructionsSummaryFormat.empty()) {
+		instructionsSummaryFormat = "csv";
+	}
+	if (instructionsSummaryFormat != "csv"
+			&& instructionsSummaryFormat != "bin") {
+		std::cerr << "invalid instructions summary format: "
+				<< instructionsSummaryFormat << std::endl
+				<< "  valid ones are csv and bin" << std::endl;
+		exit(-1);
+	}
+
 	outputFolder = getCmdOption(argv, argv + argc, "-o");
 	if (outputFolder.empty()) {
 		printHelp();
@@ -191,7 +392,49 @@ dcSimuParams::dcSimuParams(int argc, char **argv) {
 		exit(-1);
 	}
 
+	// Synthetic traffic mode, without application
+	trafficPattern = getCmdOption(argv, argv + argc, "-traffic");
+	if (!trafficPattern.empty() && trafficPattern != "uniform"
+			&& trafficPattern != "hotspot" && trafficPattern != "transpose"
+			&& trafficPattern != "bitcomp" && trafficPattern != "bursty") {
+		std::cerr << "invalid traffic pattern: " << trafficPattern << std::endl
+				<< "  valid ones are uniform, hotspot, transpose, bitcomp and bursty"
+				<< std::endl;
+		exit(-1);
+	}
+	std::string ratesString = getCmdOption(argv, argv + argc,
+			"-injectionRates");
+	if (ratesString.empty()) {
+		ratesString = "0.01,0.05,0.1,0.2,0.3,0.4,0.5,0.6,0.7,0.8,0.9,1";
+	}
+	std::istringstream ratesStream(ratesString);
+	std::string rate;
+	while (std::getline(ratesStream, rate, ',')) {
+		injectionRates.push_back(std::stod(rate));
+		if (injectionRates.back() <= 0 || injectionRates.back() > 1) {
+			std::cerr << "injection rates must be in ]0, 1] packet per cycle"
+					<< std::endl;
+			exit(-1);
+		}
+	}
+	std::string windowString = getCmdOption(argv, argv + argc,
+			"-trafficWindow");
+	trafficWindow = windowString.empty() ? 10000 : std::stol(windowString);
+
+	// Packet trace replay through the XBAR alone, without application
+	replayFile = getCmdOption(argv, argv + argc, "-replay");
+	closedLoop = cmdOptionExists(argv, argv + argc, "-closedLoop");
+	if (!replayFile.empty() && !trafficPattern.empty()) {
+		std::cerr << "-traffic and -replay cannot be used together"
+				<< std::endl;
+		exit(-1);
+	}
+	bool withoutApplication = !trafficPattern.empty() || !replayFile.empty();
+
 	mappingHeuristic = getCmdOption(argv, argv + argc, "-m");
+	if (mappingHeuristic.empty() && withoutApplication) {
+		mappingHeuristic = "ZigZag"; // not used without application
+	}
 	if (mappingHeuristic.empty()) {
 		printHelp();
 		exit(-1);
@@ -236,6 +479,9 @@ dcSimuParams::dcSimuParams(int argc, char **argv) {
 	}
 
 	schedulingStrategy = getCmdOption(argv, argv + argc, "-s");
+	if (schedulingStrategy.empty() && withoutApplication) {
+		schedulingStrategy = "fcfs"; // not used without application
+	}
 	if (schedulingStrategy.empty()) {
 		printHelp();
 		exit(-1);
@@ -249,7 +495,7 @@ dcSimuParams::dcSimuParams(int argc, char **argv) {
 	// Get application or mode file
 	appXml = getCmdOption(argv, argv + argc, "-a");
 	modeFile = getCmdOption(argv, argv + argc, "-f");
-	if (appXml.empty() && modeFile.empty()) {
+	if (appXml.empty() && modeFile.empty() && !withoutApplication) {
 		printHelp();
 		exit(-1);
 	}
@@ -269,6 +515,14 @@ dcSimuParams::dcSimuParams(int argc, char **argv) {
 		}
 	}
 
+	// Get optional platform file describing each core
+	platformFile = getCmdOption(argv, argv + argc, "-platform");
+	if (!platformFile.empty() && !std::ifstream(platformFile)) {
+		std::cerr << "platform file " << platformFile << " doesn't exist"
+				<< std::endl;
+		exit(-1);
+	}
+
 	std::string xString = getCmdOption(argv, argv + argc, "-x");
 	if (xString.empty()) {
 		printHelp();
@@ -332,6 +586,263 @@ dcSimuParams::dcSimuParams(int argc, char **argv) {
 	}
 	xbarBuffSize = std::stol(buffSizeString);
 
+	std::string mshrString = getCmdOption(argv, argv + argc, "-mshr");
+	if (!mshrString.empty()) {
+		nbMshrs = std::stoi(mshrString);
+	} else {
+		nbMshrs = 0;
+	}
+
+	std::string wcbString = getCmdOption(argv, argv + argc, "-wcb");
+	if (!wcbString.empty()) {
+		writeCombiningWindow = std::stol(wcbString);
+	} else {
+		writeCombiningWindow = 0;
+	}
+
+	std::string cacheSizeString = getCmdOption(argv, argv + argc, "-cacheSize");
+	if (!cacheSizeString.empty()) {
+		labelCacheSize = std::stol(cacheSizeString);
+	} else {
+		labelCacheSize = 0;
+	}
+	std::string cacheWaysString = getCmdOption(argv, argv + argc, "-cacheWays");
+	if (!cacheWaysString.empty()) {
+		labelCacheWays = std::stoi(cacheWaysString);
+	} else {
+		labelCacheWays = 4;
+	}
+	labelCacheCoherence = getCmdOption(argv, argv + argc, "-cacheCoherence");
+	if (labelCacheCoherence.empty()) {
+		labelCacheCoherence = "inv";
+	}
+	if (labelCacheCoherence != "inv" && labelCacheCoherence != "upd") {
+		std::cerr << "invalid label cache coherence: " << labelCacheCoherence
+				<< std::endl << "  valid ones are inv and upd" << std::endl;
+		exit(-1);
+	}
+
+	dvfsGovernor = getCmdOption(argv, argv + argc, "-dvfs");
+	if (!dvfsGovernor.empty() && dvfsGovernor != "fixed"
+			&& dvfsGovernor != "ondemand" && dvfsGovernor != "slack") {
+		std::cerr << "invalid DVFS governor: " << dvfsGovernor << std::endl
+				<< "  valid ones are fixed, ondemand and slack" << std::endl;
+		exit(-1);
+	}
+	dvfsTableFile = getCmdOption(argv, argv + argc, "-dvfsTable");
+	if (!dvfsTableFile.empty() && !std::ifstream(dvfsTableFile)) {
+		std::cerr << "DVFS table file " << dvfsTableFile << " doesn't exist"
+				<< std::endl;
+		exit(-1);
+	}
+	std::string dvfsPeriodString = getCmdOption(argv, argv + argc,
+			"-dvfsPeriod");
+	if (!dvfsPeriodString.empty()) {
+		dvfsPeriod = std::stol(dvfsPeriodString);
+	} else {
+		dvfsPeriod = 100000;
+	}
+	if (dvfsPeriod == 0) {
+		std::cerr << "DVFS governor period must be greater than 0"
+				<< std::endl;
+		exit(-1);
+	}
+	std::string dvfsLatencyString = getCmdOption(argv, argv + argc,
+			"-dvfsLatency");
+	if (!dvfsLatencyString.empty()) {
+		dvfsLatency = std::stol(dvfsLatencyString);
+	} else {
+		dvfsLatency = 10000;
+	}
+
+	// Output files written during the simulation. The summary on the
+	// standard output, Parameters.txt and the instructions summary are
+	// always written, energy estimation also needs noc_csv. The packet
+	// trace holds one line per packet, it is only written on request
+	const char *allOutputs[] = { "mapping", "runnables_csv",
+			"runnables_arff", "noc_csv", "noc_arff", "graphs", "labels" };
+	std::vector<std::string> validOutputs(allOutputs,
+			allOutputs + sizeof(allOutputs) / sizeof(allOutputs[0]));
+	std::string outputsString = getCmdOption(argv, argv + argc, "-outputs");
+	if (outputsString.empty() || outputsString == "all") {
+		outputs = validOutputs;
+	} else if (outputsString != "none") {
+		validOutputs.push_back("packet_trace");
+		std::istringstream is(outputsString);
+		std::string output;
+		while (std::getline(is, output, ',')) {
+			if (std::find(validOutputs.begin(), validOutputs.end(), output)
+					== validOutputs.end()) {
+				std::cerr << "invalid output: " << output << std::endl
+						<< "  valid ones are mapping, runnables_csv, runnables_arff, noc_csv, noc_arff, packet_trace, graphs and labels"
+						<< std::endl;
+				exit(-1);
+			}
+			outputs.push_back(output);
+		}
+	}
+
+	waveformFormat = getCmdOption(argv, argv + argc, "-waveFormat");
+	if (waveformFormat.empty()) {
+		waveformFormat = "vcd";
+	}
+	if (waveformFormat != "vcd" && waveformFormat != "bin"
+			&& waveformFormat != "none") {
+		std::cerr << "invalid waveform format: " << waveformFormat
+				<< std::endl << "  valid ones are vcd, bin and none"
+				<< std::endl;
+		exit(-1);
+	}
+	std::string waveStartString = getCmdOption(argv, argv + argc,
+			"-waveStart");
+	waveformStart = waveStartString.empty() ? 0 : std::stol(waveStartString);
+	std::string waveEndString = getCmdOption(argv, argv + argc, "-waveEnd");
+	waveformEnd = waveEndString.empty() ? 0 : std::stol(waveEndString);
+	if (waveformEnd != 0 && waveformEnd <= waveformStart) {
+		std::cerr << "waveform capture end must be after its start"
+				<< std::endl;
+		exit(-1);
+	}
+
+	std::string checkpointString = getCmdOption(argv, argv + argc,
+			"-checkpointAt");
+	checkpointTime = checkpointString.empty() ? 0 : std::stol(checkpointString);
+	checkpointMode = getCmdOption(argv, argv + argc, "-checkpointAtMode");
+	if (!checkpointMode.empty() && modeFile.empty()) {
+		std::cerr << "-checkpointAtMode needs a mode switching file (-f)"
+				<< std::endl;
+		exit(-1);
+	}
+	restoreFile = getCmdOption(argv, argv + argc, "-restore");
+
+	// Statistical sampling of the hyperperiods of a long periodic run
+	std::string hyperperiodsString = getCmdOption(argv, argv + argc,
+			"-hyperperiods");
+	nbHyperperiods =
+			hyperperiodsString.empty() ? 0 : std::stol(hyperperiodsString);
+	std::string samplesString = getCmdOption(argv, argv + argc, "-samples");
+	nbSampledHyperperiods =
+			samplesString.empty() ? nbHyperperiods : std::stol(samplesString);
+	if (!samplesString.empty()
+			&& (nbHyperperiods == 0 || nbSampledHyperperiods == 0)) {
+		std::cerr << "-samples needs -hyperperiods and at least one sample"
+				<< std::endl;
+		exit(-1);
+	}
+	if (nbSampledHyperperiods > nbHyperperiods) {
+		std::cerr << "cannot sample more hyperperiods than covered"
+				<< std::endl;
+		exit(-1);
+	}
+	if (nbHyperperiods > 0
+			&& (simuEnd > 0 || !modeFile.empty() || dontHandlePer
+					|| checkpointTime > 0 || !checkpointMode.empty()
+					|| !restoreFile.empty())) {
+		std::cerr << "-hyperperiods cannot be used with -simuEnd, -f, -np,"
+				" checkpoints or -restore" << std::endl;
+		exit(-1);
+	}
+	// The governors measure the utilization on the simulated time,
+	// which does not include the fast-forwarded hyperperiods
+	if (nbHyperperiods > 0 && !dvfsGovernor.empty()) {
+		std::cerr << "-hyperperiods cannot be used with -dvfs" << std::endl;
+		exit(-1);
+	}
+
+	// Functional XBAR model outside of the cycle-accurate windows
+	std::string windowsString = getCmdOption(argv, argv + argc,
+			"-accurateWindows");
+	std::istringstream windowsStream(windowsString);
+	std::string window;
+	while (std::getline(windowsStream, window, ',')) {
+		std::string::size_type colon = window.find(':');
+		if (colon == std::string::npos) {
+			std::cerr << "invalid cycle-accurate window: " << window
+					<< std::endl << "  expected start_in_nano:end_in_nano"
+					<< std::endl;
+			exit(-1);
+		}
+		unsigned long int windowStart = std::stol(window.substr(0, colon));
+		unsigned long int windowEnd = std::stol(window.substr(colon + 1));
+		if (windowEnd <= windowStart) {
+			std::cerr << "cycle-accurate window end must be after its start"
+					<< std::endl;
+			exit(-1);
+		}
+		accurateWindows.push_back(std::make_pair(windowStart, windowEnd));
+	}
+	std::string modesString = getCmdOption(argv, argv + argc,
+			"-accurateModes");
+	accurateAroundModes = !modesString.empty();
+	accurateBeforeMode = 0;
+	accurateAfterMode = 0;
+	if (accurateAroundModes) {
+		std::string::size_type colon = modesString.find(':');
+		if (colon == std::string::npos) {
+			std::cerr << "invalid -accurateModes: " << modesString
+					<< std::endl << "  expected before_in_nano:after_in_nano"
+					<< std::endl;
+			exit(-1);
+		}
+		accurateBeforeMode = std::stol(modesString.substr(0, colon));
+		accurateAfterMode = std::stol(modesString.substr(colon + 1));
+		if (modeFile.empty()) {
+			std::cerr << "-accurateModes needs a mode file (-f)" << std::endl;
+			exit(-1);
+		}
+	}
+	std::string afterMissString = getCmdOption(argv, argv + argc,
+			"-accurateAfterMiss");
+	accurateAfterMiss =
+			afterMissString.empty() ? 0 : std::stol(afterMissString);
+	bool withWindows = !accurateWindows.empty() || accurateAroundModes
+			|| accurateAfterMiss > 0;
+	xbarFidelity = getCmdOption(argv, argv + argc, "-fidelity");
+	if (xbarFidelity.empty()) {
+		xbarFidelity = withWindows ? "hybrid" : "accurate";
+	}
+	if (xbarFidelity != "accurate" && xbarFidelity != "functional"
+			&& xbarFidelity != "hybrid") {
+		std::cerr << "invalid XBAR fidelity: " << xbarFidelity << std::endl
+				<< "  valid ones are accurate, functional and hybrid"
+				<< std::endl;
+		exit(-1);
+	}
+	if (withWindows != (xbarFidelity == "hybrid")) {
+		std::cerr << "cycle-accurate windows (-accurateWindows, -accurateModes"
+				" or -accurateAfterMiss) are needed by and only used with"
+				" the hybrid fidelity" << std::endl;
+		exit(-1);
+	}
+	if (xbarFidelity != "accurate" && withoutApplication) {
+		std::cerr << "-traffic and -replay characterize the cycle-accurate"
+				" XBAR, -fidelity cannot be used with them" << std::endl;
+		exit(-1);
+	}
+
+	std::string progressString = getCmdOption(argv, argv + argc, "-progress");
+	progressPeriod = progressString.empty() ? 0 : std::stoi(progressString);
+	profile = cmdOptionExists(argv, argv + argc, "-profile")
+			|| progressPeriod > 0;
+
+	// Only the instruction deltas of the modes are cached, the
+	// application itself is parsed on every run
+	modeCacheFolder = getCmdOption(argv, argv + argc, "-modeCache");
+	if (!modeCacheFolder.empty() && modeFile.empty()) {
+		std::cerr << "-modeCache caches the deltas of the modes and needs"
+				" a mode file (-f)" << std::endl;
+		exit(-1);
+	}
+	if (!modeCacheFolder.empty()) {
+		struct stat cacheInfo;
+		if (stat(modeCacheFolder.c_str(), &cacheInfo) != 0
+				|| !(cacheInfo.st_mode & S_IFDIR)) {
+			std::cerr << "cannot access mode cache folder " << modeCacheFolder
+					<< std::endl;
+			exit(-1);
+		}
+	}
+
 	if (coresFrequencyInHz > 1E9) {
 		std::cerr << "Maximum supported frequency is 1GHz" << std::endl;
 		exit(-1);
@@ -345,6 +856,9 @@ dcSimuParams::dcSimuParams(int argc, char **argv) {
 	cols = std::stoi(yString);
 
 	std::string itString = getCmdOption(argv, argv + argc, "-i");
+	if (itString.empty() && withoutApplication) {
+		itString = "1"; // not used without application
+	}
 	if (itString.empty()) {
 		printHelp();
 		exit(-1);
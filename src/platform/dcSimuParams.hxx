@@ -9,6 +9,8 @@
 #define MAIN_NOC_PPA_CMAIN_DCSIMUPARAMS_HXX_
 
 #include <string>
+#include <utility>
+#include <vector>
 
 class dcSimuParams {
 public:
@@ -19,14 +21,20 @@ public:
 	std::string getSchedulingStrategy();
 	std::string getAppXml();
 	std::string getModeFile();
+	std::string getPlatformFile();
 	dcSimuParams(int argc, char** argv);
 	void printHelp();
 	bool getHelp();
 	bool getSeqDep();
 	bool getFullDuplex();
 	bool getGenerateWaveforms();
+	std::string getWaveformFormat();
+	unsigned long int getWaveformStart();
+	unsigned long int getWaveformEnd();
 	bool dontHandlePeriodic();
 	bool getRandomNonDet();
+	bool getInstructionsLog();
+	std::string getInstructionsSummaryFormat();
 	unsigned int getRows();
 	unsigned int getCols();
 	unsigned int getIterations();
@@ -39,6 +47,36 @@ public:
 	unsigned int getLocalWriteCost();
 	unsigned int getRemoteWriteCost();
 	unsigned int getRemoteReadCost();
+	unsigned int getNbMshrs();
+	unsigned long int getWriteCombiningWindow();
+	unsigned long int getLabelCacheSize();
+	unsigned int getLabelCacheWays();
+	std::string getLabelCacheCoherence();
+	std::string getDvfsGovernor();
+	std::string getDvfsTableFile();
+	unsigned long int getDvfsPeriod();
+	unsigned long int getDvfsLatency();
+	std::string getModeCacheFolder();
+	std::vector<std::string> getOutputs();
+	bool isOutputEnabled(std::string name);
+	unsigned long int getCheckpointTime();
+	std::string getCheckpointMode();
+	std::string getRestoreFile();
+	unsigned int getProgressPeriod();
+	bool getProfile();
+	std::string getTrafficPattern();
+	std::vector<double> getInjectionRates();
+	unsigned long int getTrafficWindow();
+	std::string getReplayFile();
+	bool getClosedLoop();
+	unsigned long int getNbHyperperiods();
+	unsigned long int getNbSampledHyperperiods();
+	std::string getXbarFidelity();
+	std::vector<std::pair<unsigned long int, unsigned long int> > getAccurateWindows();
+	bool getAccurateAroundModes();
+	unsigned long int getAccurateBeforeMode();
+	unsigned long int getAccurateAfterMode();
+	unsigned long int getAccurateAfterMiss();
 	unsigned int getDimension();
 
 private:
@@ -48,10 +86,13 @@ private:
 	std::string schedulingStrategy;
 	std::string appXml;
 	std::string modeFile;
+	std::string platformFile;
 	bool dontHandlePer;
 	bool help;
 	bool fullDuplex;
 	bool randomNonDet;
+	bool instructionsLog; // raw per instruction log (Instruction_fixed_Power.txt)
+	std::string instructionsSummaryFormat; // "csv" or "bin"
 	bool seqDep;
 	unsigned int rows;
 	unsigned int cols;
@@ -66,6 +107,38 @@ private:
 	unsigned int localWriteCost;
 	unsigned int remoteWriteCost;
 	unsigned int remoteReadCost;
+	unsigned int nbMshrs; // 0 means remote reads are blocking
+	unsigned long int writeCombiningWindow; // in ns, 0 means no write combining
+	unsigned long int labelCacheSize; // in bytes, 0 means no label cache
+	unsigned int labelCacheWays;
+	std::string labelCacheCoherence; // "inv" or "upd" for write-invalidate and write-update
+	std::string dvfsGovernor; // empty means no DVFS
+	std::string dvfsTableFile;
+	unsigned long int dvfsPeriod; // in ns
+	unsigned long int dvfsLatency; // in ns
+	std::string modeCacheFolder; // empty means no mode deltas cache
+	std::vector<std::string> outputs; // enabled output files
+	std::string waveformFormat; // "vcd", "bin" or "none"
+	unsigned long int waveformStart; // in ns
+	unsigned long int waveformEnd; // in ns, 0 means end of simulation
+	unsigned long int checkpointTime; // in ns, 0 means no checkpoint
+	std::string checkpointMode; // empty means no checkpoint at a mode switch
+	std::string restoreFile; // empty means simulation from time 0
+	unsigned int progressPeriod; // in wall clock seconds, 0 means no progress lines
+	bool profile; // progress lines or SIGUSR1 profile snapshots during the run
+	std::string trafficPattern; // empty means application simulation
+	std::vector<double> injectionRates; // in packets per cycle per core
+	unsigned long int trafficWindow; // measurement cycles per injection rate
+	std::string replayFile; // empty means no packet trace replay
+	bool closedLoop; // replayed injections follow the replayed deliveries
+	unsigned long int nbHyperperiods; // covered by the run, 0 means no sampling
+	unsigned long int nbSampledHyperperiods; // simulated in detail
+	std::string xbarFidelity; // "accurate", "functional" or "hybrid"
+	std::vector<std::pair<unsigned long int, unsigned long int> > accurateWindows; // in ns, [start, end[
+	bool accurateAroundModes; // cycle-accurate around each mode switch
+	unsigned long int accurateBeforeMode; // in ns
+	unsigned long int accurateAfterMode; // in ns
+	unsigned long int accurateAfterMiss; // in ns, 0 means not after deadline misses
 };
 
 
@@ -9,7 +9,11 @@
 ////////////////////
 #include <fstream>
 #include <utility>
+#include <tuple>
+#include <cstring>
+#include <unistd.h>
 #include "dcSystem.hxx"
+#include "checkpoint.hxx"
 
 namespace dreamcloud {
 namespace platform_sclib {
@@ -18,23 +22,17 @@ int dcSystem::bufferSize = 0;
 
 /**
  * SystemC method used to get completed runnables from PEs and to enable
- * runnables dependent on the completed ones.
+ * runnables dependent on the completed ones. PEs push the runnables
+ * they complete in a shared queue so only completed runnables are
+ * visited, whatever the number of PEs.
  */
 void dcSystem::dependentRunnablesReleaser_method() {
+	profiler.activated(simulationProfiler::RELEASERS);
 
-	// Copy all completed dcRunnableInstance ids from PEs into dcSystem and erase them in PE_XY
-	vector<dcRunnableInstance *> completedRunInstances;
-	for (unsigned int x = 0; x < params.getRows(); x++) {
-		for (unsigned int y = 0; y < params.getCols(); y++) {
-			processingElement *pe = pes[x][y];
-			for (std::vector<dcRunnableInstance *>::const_iterator i =
-					pe->completedRunInstances.begin();
-					i != pe->completedRunInstances.end(); ++i) {
-				completedRunInstances.push_back(*i);
-				nbRunnablesCompleted++;
-			}
-		}
-	}
+	// Take all the completed dcRunnableInstance from the completion queue
+	vector<dcRunnableInstance *> completed;
+	completed.swap(completedRunInstances);
+	nbRunnablesCompleted += completed.size();
 
 	// When we don't handle periodics stop the simulation when all
 	// the runnables (periodic and non periodic) have been executed once
@@ -46,6 +44,10 @@ void dcSystem::dependentRunnablesReleaser_method() {
 	if (simulationEndFromCmdLine == 0 && simulationEndFromMode == 0
 			&& (params.dontHandlePeriodic() || hyperPeriod == 0)) {
 		if (nbRunnablesCompleted / runnables.size() >= params.getIterations()) {
+			for (vector<dcRunnableInstance *>::iterator it = completed.begin();
+					it != completed.end(); ++it) {
+				runInstancePool.release(*it);
+			}
 			stopSimu_event.notify();
 			return;
 		}
@@ -54,18 +56,18 @@ void dcSystem::dependentRunnablesReleaser_method() {
 		}
 	}
 
-	// Loop over all the completed runnables
-	for (vector<dcRunnableInstance *>::size_type i = 0;
-			i < completedRunInstances.size(); ++i) {
+	// Loop over all the completed runnables, release their dependents
+	// and delete them
+	for (vector<dcRunnableInstance *>::iterator i = completed.begin();
+			i != completed.end(); ++i) {
 		// Loop over all runnableCalls that depend on the completed one
-		dcRunnableInstance *runInst = completedRunInstances.at(i);
-		dcRunnableCall* runCall = runInst->getRunCall();
+		dcRunnableCall* runCall = (*i)->getRunCall();
 		vector<dcRunnableCall*> enabledToExecute = runCall->GetListOfEnables();
 		for (std::vector<dcRunnableCall*>::iterator it =
 				enabledToExecute.begin(); it != enabledToExecute.end(); ++it) {
 			// If all the previous runnables of the current dependent are completed, release it (the dependent one)
 			if ((*it)->GetEnabledBy() == (*it)->GetListOfEnablers().size()) {
-				dcRunnableInstance * runInst = new dcRunnableInstance(*it);
+				dcRunnableInstance * runInst = runInstancePool.create(*it);
 				releaseRunnable(runInst);
 			}
 			// Else only indicate that one dependency has been satisfied
@@ -73,19 +75,7 @@ void dcSystem::dependentRunnablesReleaser_method() {
 				(*it)->SetEnabledBy((*it)->GetEnabledBy() + 1);
 			}
 		}
-	}
-
-	// Delete all completed runnable instances
-	for (unsigned int x = 0; x < params.getRows(); x++) {
-		for (unsigned int y = 0; y < params.getCols(); y++) {
-			processingElement *pe = pes[x][y];
-			for (std::vector<dcRunnableInstance *>::const_iterator i =
-					pe->completedRunInstances.begin();
-					i != pe->completedRunInstances.end(); ++i) {
-				delete (*i);
-			}
-			pe->completedRunInstances.clear();
-		}
+		runInstancePool.release(*i);
 	}
 }
 
@@ -176,13 +166,38 @@ void dcSystem::dumpTaskGraphFile() {
  */
 void dcSystem::modeSwitcher_thread() {
 	vector<mode_t>::size_type modIdx = 0;
+
+	// A restored simulation applies the modes up to the restored one
+	// at the checkpoint time, whose mapping calls are replayed by
+	// restorer_thread, and waits for the next one
+	if (restoreTimeInNano > 0) {
+		wait(restored_event);
+		for (vector<mode_t>::size_type i = 0; i <= currentMode; i++) {
+			if (modes.at(i).name.compare("end")) {
+				applyModeDeltas(modes.at(i));
+			}
+		}
+		if (currentMode + 1 >= modes.size()) {
+			stopSimu_event.notify();
+			return;
+		}
+		modIdx = currentMode + 1;
+		wait(modes.at(modIdx).time - restoreTimeInNano, SC_NS);
+	}
+
 	while (true) {
+		profiler.activated(simulationProfiler::MODE_SWITCHER);
 		unsigned long int nowInNano = sc_time_stamp().value() * 1E-3;
 		if (modes.at(modIdx).name.compare("end")) {
+			journalMappingCall(SWITCH_MODE, modIdx, 0);
 			mappingHeuristic->switchMode(nowInNano, modes.at(modIdx).file,
 					modes.at(modIdx).name);
 			labelsMapper_method();
-			updateInstructionsExecTimeBounds(modes.at(modIdx).file);
+			applyModeDeltas(modes.at(modIdx));
+			currentMode = modIdx;
+			if (modes.at(modIdx).name == params.getCheckpointMode()) {
+				saveCheckpoint();
+			}
 		}
 		assert(
 				modes.at(modIdx).time == nowInNano
@@ -204,6 +219,7 @@ void dcSystem::modeSwitcher_thread() {
  * iteration_event notification.
  */
 void dcSystem::nonPeriodicIndependentRunnablesReleaser_method() {
+	profiler.activated(simulationProfiler::RELEASERS);
 	vector<dcRunnableCall *> runs;
 	if (params.dontHandlePeriodic()) {
 		runs = application->GetIndependentRunnables(taskGraph);
@@ -218,15 +234,18 @@ void dcSystem::nonPeriodicIndependentRunnablesReleaser_method() {
 	}
 	for (std::vector<dcRunnableCall *>::iterator it = runs.begin();
 			it != runs.end(); ++it) {
-		dcRunnableInstance * runInst = new dcRunnableInstance(*it);
+		dcRunnableInstance * runInst = runInstancePool.create(*it);
 		releaseRunnable(runInst);
 	}
 }
 
 /**
- * SystemC thread used to release periodic runnables.
- * This thread is triggered at initialization time and then dynamically
- * computes its next occurrence.
+ * SystemC thread releasing periodic and sporadic runnables. It is
+ * triggered at initialization time and then waits for the next
+ * release. Runnables sharing the same period and offset are released
+ * together by a group whose next release time is kept in a min-heap,
+ * so a wake-up only visits the released groups. Groups with a null
+ * period are released once at their offset.
  */
 void dcSystem::periodicRunnablesReleaser_thread() {
 
@@ -235,22 +254,38 @@ void dcSystem::periodicRunnablesReleaser_thread() {
 		return;
 	}
 
-	vector<int>::size_type nbPeriodicRunnables =
-			periodicAndSporadicRunnables.size();
-	vector<unsigned long int> remainingTimeBeforeRelease(nbPeriodicRunnables);
-	for (vector<int>::size_type i = 0; i < nbPeriodicRunnables; ++i) {
+	// Group runnables by (period, offset)
+	map<pair<unsigned long int, unsigned long int>, unsigned int> groupIndexes;
+	for (vector<int>::size_type i = 0; i < periodicAndSporadicRunnables.size();
+			++i) {
 		dcRunnableCall *runnable = periodicAndSporadicRunnables.at(i);
-		remainingTimeBeforeRelease[i] = runnable->GetOffsetInNano();
+		pair<unsigned long int, unsigned long int> key = std::make_pair(
+				(unsigned long int) runnable->GetPeriodInNano(),
+				(unsigned long int) runnable->GetOffsetInNano());
+		if (groupIndexes.find(key) == groupIndexes.end()) {
+			groupIndexes[key] = releaseGroups.size();
+			releaseGroup_t group;
+			group.periodInNano = key.first;
+			releaseGroups.push_back(group);
+			releaseCalendar.push(std::make_pair(key.second, groupIndexes[key]));
+		}
+		releaseGroups[groupIndexes[key]].runnables.push_back(i);
+	}
+
+	// The calendar is part of the restored state
+	if (restoreTimeInNano > 0) {
+		wait(restored_event);
 	}
 
 	while (true) {
+		profiler.activated(simulationProfiler::RELEASERS);
 
-		// Stop the simu if hyper period reached and we are not using neither mode switch
-		// nor simu duration from command line
+		// Stop the simu if hyper period (or the last sampled one) reached and we
+		// are not using neither mode switch nor simu duration from command line
 		unsigned long int currentTimeInNano = (sc_time_stamp().value() / 1E3);
 		if (simulationEndFromCmdLine == 0 && simulationEndFromMode == 0
 				&& !params.dontHandlePeriodic() && hyperPeriod > 0
-				&& currentTimeInNano >= hyperPeriod) {
+				&& currentTimeInNano >= hyperPeriod * nbDetailedHyperperiods) {
 			stopSimu_event.notify();
 			return;
 		}
@@ -263,21 +298,33 @@ void dcSystem::periodicRunnablesReleaser_thread() {
 			return;
 		}
 
-		unsigned long int waitTime = ULONG_MAX;
-		for (vector<int>::size_type i = 0; i < nbPeriodicRunnables; ++i) {
-			if (remainingTimeBeforeRelease[i] == 0) {
-				dcRunnableCall *runnable = periodicAndSporadicRunnables.at(i);
-				dcRunnableInstance * runInst = new dcRunnableInstance(runnable);
-				releaseRunnable(runInst);
-				remainingTimeBeforeRelease[i] = runnable->GetPeriodInNano();
-			}
-			if (remainingTimeBeforeRelease[i] < waitTime) {
-				waitTime = remainingTimeBeforeRelease[i];
+		// Release the due groups, in the order of the runnables
+		// in the application
+		vector<unsigned int> released;
+		while (!releaseCalendar.empty()
+				&& releaseCalendar.top().first <= currentTimeInNano) {
+			calendarEntry_t entry = releaseCalendar.top();
+			releaseCalendar.pop();
+			releaseGroup_t &group = releaseGroups[entry.second];
+			released.insert(released.end(), group.runnables.begin(),
+					group.runnables.end());
+			if (group.periodInNano > 0) {
+				releaseCalendar.push(
+						std::make_pair(entry.first + group.periodInNano,
+								entry.second));
 			}
 		}
-		for (vector<int>::size_type i = 0; i < nbPeriodicRunnables; ++i) {
-			remainingTimeBeforeRelease[i] = remainingTimeBeforeRelease[i]
-					- waitTime;
+		std::sort(released.begin(), released.end());
+		for (vector<unsigned int>::iterator it = released.begin();
+				it != released.end(); ++it) {
+			dcRunnableInstance * runInst = runInstancePool.create(
+					periodicAndSporadicRunnables.at(*it));
+			releaseRunnable(runInst);
+		}
+
+		unsigned long int waitTime = ULONG_MAX;
+		if (!releaseCalendar.empty()) {
+			waitTime = releaseCalendar.top().first - currentTimeInNano;
 		}
 		if (simulationEndFromCmdLine != 0) {
 			unsigned long int toEnd = simulationEndFromCmdLine
@@ -312,9 +359,17 @@ string dcSystem::getFrequencyString(unsigned long int freqInHertz) {
  * SystemC method called once only during initialization.
  */
 void dcSystem::labelsMapper_method() {
+	journalMappingCall(MAP_LABELS, 0, 0);
+	mapLabels(sc_time_stamp().value());
+}
+
+/**
+ * Map the labels at the given time and give the mapping to the PEs.
+ */
+void dcSystem::mapLabels(unsigned long int timeInPico) {
 	for (vector<dcLabel*>::size_type i = 0; i < labels.size(); i++) {
 		dcMappingHeuristicI::dcMappingLocation loc = mappingHeuristic->mapLabel(
-				labels.at(i)->GetID(), sc_time_stamp().value() * 1E-3,
+				labels.at(i)->GetID(), timeInPico * 1E-3,
 				labels.at(i)->GetName());
 		// All the PEs have a local copy of the labels mapping table
 		for (unsigned int row(0); row < params.getRows(); ++row) {
@@ -326,65 +381,86 @@ void dcSystem::labelsMapper_method() {
 	}
 }
 
+/**
+ * SystemC thread mapping the released runnables. Each runnable is
+ * mapped once, when released, in the pending queue of its PE. The
+ * head of a queue is sent to its PE once the PE has received the
+ * previous one. The thread sleeps when no runnable is released and
+ * no PE can receive its pending runnable.
+ */
 void dcSystem::runnablesMapper_thread() {
 
-	int appIterations = 0;
-	int remainingNbRunnablesToMap = runnables.size();
+	appIterations = 0;
+	remainingNbRunnablesToMap = runnables.size();
 	for (unsigned int row(0); row < params.getRows(); ++row) {
 		for (unsigned int col(0); col < params.getCols(); ++col) {
 			pes[row][col]->newRunnableSignal = false;
 		}
 	}
+	pendingRunnables.resize(params.getDimension());
 
 	// Map runnables until application is "finished"
 	while (true) {
+		profiler.activated(simulationProfiler::MAPPER);
 
-		// Wait until a runnable can be executed or we reached hyper period
-		if (readyRunnables.empty()) {
-			wait();
-			continue;
+		// Ask the mapping heuristic where to map the released runnables
+		for (vector<dcRunnableInstance*>::iterator it = readyRunnables.begin();
+				it != readyRunnables.end(); ++it) {
+			dcRunnableCall * runCall = (*it)->getRunCall();
+			journalMappingCall(MAP_RUNNABLE,
+					std::find(runnables.begin(), runnables.end(), runCall)
+							- runnables.begin(), (*it)->GetPeriodId());
+			dcMappingHeuristicI::dcMappingLocation pe =
+					mappingHeuristic->mapRunnable(sc_time_stamp().value(),
+							runCall->GetRunClassId(),
+							runCall->GetRunClassName(),
+							runCall->GetTask()->GetName(),
+							runCall->GetTask()->GetID(),
+							runCall->GetIdInTask(), (*it)->GetPeriodId());
+			unsigned int peIndex = pe.first * params.getCols() + pe.second;
+			pendingRunnables[peIndex].push_back(*it);
+			pesWithPendingRunnables.insert(peIndex);
 		}
+		readyRunnables.clear();
 
-		// Ask the mapping heuristic where to map the current ready runnable
-		dcRunnableCall * runCall = readyRunnables.front()->getRunCall();
-		dcMappingHeuristicI::dcMappingLocation pe =
-				mappingHeuristic->mapRunnable(sc_time_stamp().value(),
-						runCall->GetRunClassId(), runCall->GetRunClassName(),
-						runCall->GetTask()->GetName(),
-						runCall->GetTask()->GetID(), runCall->GetIdInTask(),
-						readyRunnables.front()->GetPeriodId());
-		int x = pe.first;
-		int y = pe.second;
-
-		// If the PE has completed receiving the previous runnable,
-		// map the new one on it
-		// ONE clock cycle
-		if (!pes[x][y]->newRunnableSignal) {
-			runnablesMappingCsvFile
-					<< readyRunnables.front()->getRunCall()->GetRunClassId()
-					<< ","
-					<< readyRunnables.front()->getRunCall()->GetRunClassName()
-					<< "," << x << y << endl;
+		// Send a pending runnable to each PE which has received the
+		// previous one
+		// ONE clock cycle per runnable sent
+		bool sent = false;
+		for (std::set<unsigned int>::iterator it =
+				pesWithPendingRunnables.begin();
+				it != pesWithPendingRunnables.end();) {
+			unsigned int x = *it / params.getCols();
+			unsigned int y = *it % params.getCols();
+			if (pes[x][y]->newRunnableSignal) {
+				++it;
+				continue;
+			}
+			dcRunnableInstance *runnable = pendingRunnables[*it].front();
+			pendingRunnables[*it].pop_front();
+			if (pendingRunnables[*it].empty()) {
+				it = pesWithPendingRunnables.erase(it);
+			} else {
+				++it;
+			}
+			sinks.runnableMapped(runnable, x, y);
 			nbRunnablesMapped++;
-			readyRunnables.front()->SetMappingTime(sc_time_stamp().value());
-			pes[x][y]->newRunnable = readyRunnables.front();
+			runnable->SetMappingTime(sc_time_stamp().value());
+			pes[x][y]->newRunnable = runnable;
 			pes[x][y]->newRunnableSignal = true;
 			newRunnable_event[x][y].notify();
-			readyRunnables.erase(readyRunnables.begin());
 			remainingNbRunnablesToMap--;
 			if (remainingNbRunnablesToMap == 0) {
 				appIterations++;
 				remainingNbRunnablesToMap = runnables.size();
 			}
+			sent = true;
 			wait(1, SC_NS);
 		}
 
-		// Else move the current runnable to the end of the independent queue
-		// ONE clock cycle
-		else {
-			readyRunnables.push_back(readyRunnables.front());
-			readyRunnables.erase(readyRunnables.begin());
-			wait(1, SC_NS);
+		// Wait until a runnable is released or received by a PE
+		if (!sent && readyRunnables.empty()) {
+			wait(runnableReleased_event | runnableConsumed_event);
 		}
 	}
 }
@@ -402,15 +478,540 @@ void dcSystem::parseModeFile(string file) {
 		getline(is, modeFile, ';');
 		string::size_type sz;
 		unsigned long int timeInNano = stod(timeString, &sz) * 1E9;
-		mode_t mode { timeInNano, modeName, modeFile };
+		mode_t mode { timeInNano, modeName, modeFile, vector<
+				instructionDelta_t>() };
 		modes.push_back(mode);
 	}
 }
 
+/**
+ * Parse the given AMALTHEA file and convert it to a dcApplication graph.
+ */
+parsedApplication dcSystem::parseApplication(string appPath, bool seqDep) {
+	parsedApplication app;
+	dcAmaltheaParser amaltheaParser;
+	app.amApplication = new AmApplication();
+	amaltheaParser.ParseAmaltheaFile(appPath, app.amApplication);
+	app.application = new dcApplication();
+	app.taskGraph = app.application->createGraph("dcTaskGraph");
+	app.application->CreateGraphEntities(app.taskGraph, app.amApplication,
+			seqDep);
+	return app;
+}
+
+/**
+ * Return the application file, given directly or as the file of the
+ * first line of the mode switching file.
+ */
+string dcSystem::getApplicationFile(dcSimuParams &params) {
+	if (!params.getAppXml().empty()) {
+		return params.getAppXml();
+	}
+	std::ifstream infile(params.getModeFile());
+	std::string line;
+	std::string modeFile;
+	if (std::getline(infile, line)) {
+		istringstream is(line);
+		string field;
+		getline(is, field, ';');
+		getline(is, field, ';');
+		getline(is, modeFile, ';');
+	}
+	return modeFile;
+}
+
+/**
+ * Return the type of each PE (row major order).
+ *
+ * When a platform file is given, each of its lines describes one PE as
+ *   row,col,coreType,frequencyInHz,clockDomain
+ * where coreType is either the name of a core type of the application
+ * (whose instructionsPerCycle is used) or a number of cycles per
+ * instruction. frequencyInHz and clockDomain are optional and default
+ * to the cores frequency and to domain 0. Empty lines and lines
+ * starting with '#' are ignored.
+ *
+ * Without platform file, the application core types are assigned to
+ * the PEs in turn and all PEs run at the cores frequency.
+ */
+vector<processingElementType> dcSystem::createPeTypes(
+		AmApplication *amApplication) {
+	map<string, dcCoreType*> coreTypes = amApplication->getCoreTypesMap();
+	vector<processingElementType> peTypes;
+
+	// Without platform file all the PEs have the same type, the first
+	// core type of the application whose instructionsPerCycle is not 1
+	if (params.getPlatformFile().empty()) {
+		int instructionsPerCycle = 1;
+		string name;
+		for (map<string, dcCoreType*>::iterator it = coreTypes.begin();
+				it != coreTypes.end(); ++it) {
+			if (instructionsPerCycle == 1) {
+				instructionsPerCycle = it->second->GetInstructionsPerCycle();
+				name = it->first;
+			}
+		}
+		peTypes.resize(params.getDimension(),
+				processingElementType(params.getCoresFrequencyInHz(),
+						instructionsPerCycle, name));
+		return peTypes;
+	}
+
+	vector<bool> defined(params.getDimension(), false);
+	peTypes.resize(params.getDimension(),
+			processingElementType(params.getCoresFrequencyInHz(), 1));
+	std::ifstream infile(params.getPlatformFile());
+	std::string line;
+	while (std::getline(infile, line)) {
+		if (line.empty() || line[0] == '#') {
+			continue;
+		}
+		istringstream is(line);
+		string rowString, colString, typeString, freqString, domainString;
+		getline(is, rowString, ',');
+		getline(is, colString, ',');
+		getline(is, typeString, ',');
+		getline(is, freqString, ',');
+		getline(is, domainString, ',');
+		unsigned int row = parsePlatformNumber(rowString, "row");
+		unsigned int col = parsePlatformNumber(colString, "column");
+		if (row >= params.getRows() || col >= params.getCols()) {
+			cerr << "invalid PE " << row << "," << col << " in platform file "
+					<< params.getPlatformFile() << endl;
+			exit(-1);
+		}
+		unsigned long int nbCyclesPerInstructions;
+		if (coreTypes.find(typeString) != coreTypes.end()) {
+			nbCyclesPerInstructions =
+					coreTypes[typeString]->GetInstructionsPerCycle();
+		} else if (!typeString.empty()
+				&& typeString.find_first_not_of("0123456789")
+						== string::npos) {
+			nbCyclesPerInstructions = parsePlatformNumber(typeString,
+					"core type");
+		} else {
+			cerr << "unknown core type " << typeString << " in platform file "
+					<< params.getPlatformFile() << endl;
+			exit(-1);
+		}
+		unsigned long int frequencyInHz = params.getCoresFrequencyInHz();
+		if (!freqString.empty()) {
+			frequencyInHz = parsePlatformNumber(freqString, "frequency");
+		}
+		if (frequencyInHz > 1E9) {
+			cerr << "Maximum supported frequency is 1GHz" << endl;
+			exit(-1);
+		}
+		unsigned int clockDomain = 0;
+		if (!domainString.empty()) {
+			clockDomain = parsePlatformNumber(domainString, "clock domain");
+		}
+		peTypes[row * params.getCols() + col] = processingElementType(
+				frequencyInHz, nbCyclesPerInstructions, typeString,
+				clockDomain);
+		defined[row * params.getCols() + col] = true;
+	}
+	for (unsigned int i = 0; i < params.getDimension(); i++) {
+		if (!defined[i]) {
+			cerr << "PE " << i / params.getCols() << "," << i % params.getCols()
+					<< " is missing in platform file "
+					<< params.getPlatformFile() << endl;
+			exit(-1);
+		}
+	}
+	return peTypes;
+}
+
+/**
+ * Return the value of a numeric field of the platform file, exit with
+ * an error message if it is not a number.
+ */
+unsigned long int dcSystem::parsePlatformNumber(string value, string field) {
+	if (value.empty() || value.find_first_not_of("0123456789") != string::npos
+			|| value.size() > 18) {
+		cerr << "invalid " << field << " " << value << " in platform file "
+				<< params.getPlatformFile() << endl;
+		exit(-1);
+	}
+	return stol(value);
+}
+
+/**
+ * Return the DVFS operating points of the given file, sorted by
+ * increasing frequency. Each line of the file describes one point as
+ *   frequencyInHz,voltage
+ * Empty lines and lines starting with '#' are ignored.
+ */
+vector<operatingPoint> dcSystem::parseDvfsTable(string file) {
+	vector<operatingPoint> table;
+	std::ifstream infile(file);
+	std::string line;
+	while (std::getline(infile, line)) {
+		if (line.empty() || line[0] == '#') {
+			continue;
+		}
+		istringstream is(line);
+		string freqString, voltageString;
+		getline(is, freqString, ',');
+		getline(is, voltageString, ',');
+		operatingPoint point;
+		point.frequencyInHz = stol(freqString);
+		point.voltage = voltageString.empty() ? 1.0 : stod(voltageString);
+		if (point.frequencyInHz == 0 || point.frequencyInHz > 1E9) {
+			cerr << "invalid frequency " << freqString << " in DVFS table "
+					<< file << endl;
+			exit(-1);
+		}
+		table.push_back(point);
+	}
+	if (table.empty()) {
+		cerr << "DVFS table " << file << " is empty" << endl;
+		exit(-1);
+	}
+	std::sort(table.begin(), table.end(),
+			[](const operatingPoint &left, const operatingPoint &right)
+			{
+				return left.frequencyInHz < right.frequencyInHz;
+			});
+	return table;
+}
+
+/**
+ * Group the PEs by clock domain and create the governor. Without
+ * DVFS table, each domain gets 4 operating points at 25, 50, 75 and
+ * 100 % of the frequency of its PEs, with voltages relative to the
+ * nominal one. Each domain starts at the fastest operating point that
+ * is not above the frequency of its PEs, which must all have the same.
+ */
+void dcSystem::createClockDomains() {
+	governor = dvfsGovernor::create(params.getDvfsGovernor());
+	vector<operatingPoint> table;
+	if (!params.getDvfsTableFile().empty()) {
+		table = parseDvfsTable(params.getDvfsTableFile());
+	}
+
+	map<unsigned int, unsigned int> domainIndexes;
+	map<unsigned int, unsigned long int> nominalFrequencies;
+	for (unsigned int row(0); row < params.getRows(); ++row) {
+		for (unsigned int col(0); col < params.getCols(); ++col) {
+			processingElement *pe = pes[row][col];
+			unsigned int id = pe->getType().getClockDomain();
+			if (domainIndexes.find(id) == domainIndexes.end()) {
+				domainIndexes[id] = clockDomains.size();
+				clockDomain_t domain;
+				domain.id = id;
+				unsigned long int nominalFrequencyInHz =
+						pe->getType().getFrequencyInHz();
+				nominalFrequencies[id] = nominalFrequencyInHz;
+				domain.operatingPoints = table;
+				if (table.empty()) {
+					for (unsigned int i = 1; i <= 4; i++) {
+						operatingPoint point = { nominalFrequencyInHz * i / 4,
+								i / 4.0 };
+						domain.operatingPoints.push_back(point);
+					}
+				}
+				domain.current = 0;
+				for (unsigned int i = 0; i < domain.operatingPoints.size();
+						i++) {
+					if (domain.operatingPoints[i].frequencyInHz
+							<= nominalFrequencyInHz) {
+						domain.current = i;
+					}
+				}
+				domain.residencyInNano.resize(domain.operatingPoints.size(),
+						0);
+				domain.lastTransitionInNano = 0;
+				domain.nbTransitions = 0;
+				clockDomains.push_back(domain);
+			}
+			if (pe->getType().getFrequencyInHz() != nominalFrequencies[id]) {
+				cerr << "PE" << row << col << " runs at "
+						<< pe->getType().getFrequencyInHz()
+						<< " Hz but other PEs of clock domain " << id
+						<< " run at " << nominalFrequencies[id] << " Hz"
+						<< endl;
+				exit(-1);
+			}
+			clockDomain_t &domain = clockDomains[domainIndexes[id]];
+			domain.pes.push_back(pe);
+			domain.lastComputationTime.push_back(0);
+			pe->initFrequencyInHz(
+					domain.operatingPoints[domain.current].frequencyInHz);
+		}
+	}
+
+	dvfsTransitionsCsvFile.open(
+			params.getOutputFolder() + "/OUTPUT_DVFS_Transitions.csv");
+	dvfsTransitionsCsvFile
+			<< "Time(NS),Clock_Domain,From_Frequency(Hz),To_Frequency(Hz),Voltage,Utilization,Min_Slack_Ratio,Deadlines_Missed"
+			<< endl;
+}
+
+/**
+ * Dump the number of executions and of executed instructions of each
+ * (PE, runnable, instruction index) for the energy estimator, either
+ * in Instruction_Summary.csv or in Instruction_Summary.bin. The binary
+ * file starts with the "DCIS" magic and a 32 bits version followed by
+ * one record per line of the CSV file:
+ *   uint32 row, uint32 col, uint32 instruction index,
+ *   uint32 runnable name length, runnable name (not null terminated),
+ *   uint64 nb of executions, uint64 nb of instructions
+ */
+void dcSystem::dumpInstructionsSummary() {
+	bool binary = params.getInstructionsSummaryFormat() == "bin";
+	ofstream f;
+	if (binary) {
+		f.open(params.getOutputFolder() + "/Instruction_Summary.bin",
+				ios::out | ios::binary);
+		uint32_t version = 1;
+		f.write("DCIS", 4);
+		f.write(reinterpret_cast<const char*>(&version), sizeof(version));
+	} else {
+		f.open(params.getOutputFolder() + "/Instruction_Summary.csv");
+		f << "PE,Runnable,Instruction_ID,Nb_Executions,Nb_Instructions"
+				<< endl;
+	}
+
+	// Counters are keyed by runnable call address, they are written by
+	// runnable name, instruction id and then application order so that
+	// the output is the same from one run to the other
+	map<dcRunnableCall *, unsigned int> runnableIndexes;
+	for (unsigned int i = 0; i < runnables.size(); i++) {
+		runnableIndexes[runnables.at(i)] = i;
+	}
+	typedef map<pair<dcRunnableCall *, int>,
+			processingElement::instructionCounters>::iterator counterIterator;
+	for (unsigned int row(0); row < params.getRows(); ++row) {
+		for (unsigned int col(0); col < params.getCols(); ++col) {
+			map<pair<dcRunnableCall *, int>,
+					processingElement::instructionCounters> &counters =
+					pes[row][col]->executedInstructions;
+			map<std::tuple<string, int, unsigned int>, counterIterator> ordered;
+			for (counterIterator it = counters.begin(); it != counters.end();
+					++it) {
+				ordered[std::make_tuple(it->first.first->GetRunClassName(),
+						it->first.second, runnableIndexes[it->first.first])] =
+						it;
+			}
+			for (map<std::tuple<string, int, unsigned int>, counterIterator>::iterator o =
+					ordered.begin(); o != ordered.end(); ++o) {
+				counterIterator it = o->second;
+				string name = it->first.first->GetRunClassName();
+				if (binary) {
+					uint32_t header[4] = { row, col,
+							static_cast<uint32_t>(it->first.second),
+							static_cast<uint32_t>(name.size()) };
+					uint64_t values[2] = { it->second.nbExecutions,
+							it->second.nbInstructions };
+					f.write(reinterpret_cast<const char*>(header),
+							sizeof(header));
+					f.write(name.c_str(), name.size());
+					f.write(reinterpret_cast<const char*>(values),
+							sizeof(values));
+				} else {
+					f << "PE" << row << col << "," << name << ","
+							<< it->first.second << ","
+							<< it->second.nbExecutions << ","
+							<< it->second.nbInstructions << endl;
+				}
+			}
+		}
+	}
+	f.close();
+}
+
 void dcSystem::releaseRunnable(dcRunnableInstance *runnable) {
 	runnable->SetReleaseTime(sc_time_stamp().value());
 	readyRunnables.push_back(runnable);
 	runnableReleased_event.notify();
+	profiler.runnableReleased();
+}
+
+/**
+ * Copy in the profiler the counters kept by the XBAR.
+ */
+void dcSystem::updateProfilerCounters() {
+	profiler.setActivations(simulationProfiler::XBAR, xbar->nbActivations);
+	profiler.setPackets(xbar->GetTotalPacketExchanged());
+}
+
+/**
+ * Host thread printing a progress line every -progress seconds of
+ * wall clock time and a profile snapshot when SIGUSR1 is received,
+ * both on the error output so that they are seen while the standard
+ * output is redirected to the execution report. The counters are read
+ * while the simulation runs, so they may lag a few events behind.
+ */
+void dcSystem::pollProfiler() {
+	while (!profilerStopped) {
+		std::this_thread::sleep_for(
+				std::chrono::milliseconds(PROFILER_POLL_PERIOD_IN_MILLI));
+		unsigned long int nowInNano = sc_time_stamp().value() / 1E3;
+		if (simulationProfiler::takeSnapshotRequest()) {
+			updateProfilerCounters();
+			profiler.printProfile(cerr, nowInNano);
+		}
+		if (params.getProgressPeriod() > 0
+				&& profiler.getSecondsSinceProgress()
+						>= params.getProgressPeriod()) {
+			updateProfilerCounters();
+			profiler.printProgress(cerr, nowInNano);
+		}
+	}
+}
+
+/**
+ * Stop the profiler host thread before the final report, if started.
+ */
+void dcSystem::stopProfilerPoller() {
+	profilerStopped = true;
+	if (profilerPoller.joinable()) {
+		profilerPoller.join();
+	}
+}
+
+/**
+ * SystemC thread starting a new sample at the end of each hyperperiod
+ * simulated in detail. The hyperperiods skipped before it are executed
+ * by the functional model of each PE, with the runnables the PE
+ * completed during the previous sample.
+ */
+void dcSystem::hyperperiodSampler_thread() {
+	for (unsigned long int s = 1; s < sampling->getNbSamples(); s++) {
+		wait(hyperPeriod, SC_NS);
+		profiler.activated(simulationProfiler::RELEASERS);
+		unsigned long int nbSkipped = sampling->startSample(s);
+		if (nbSkipped == 0) {
+			continue;
+		}
+		for (unsigned int row(0); row < params.getRows(); ++row) {
+			for (unsigned int col(0); col < params.getCols(); ++col) {
+				pes[row][col]->fastForward(
+						sampling->getPreviousRunnables(
+								row * params.getCols() + col), nbSkipped);
+			}
+		}
+	}
+}
+
+/**
+ * Send the entries of every PE write combining buffer and wait until
+ * every write packet sent is either received by its destination or
+ * dropped by the XBAR.
+ */
+void dcSystem::drainCombinedWrites() {
+	for (unsigned int row(0); row < params.getRows(); ++row) {
+		for (unsigned int col(0); col < params.getCols(); ++col) {
+			pes[row][col]->drainCombinedWrites();
+		}
+	}
+	bool draining = true;
+	while (draining) {
+		wait(params.getCoresPeriodInNano(), SC_NS);
+		draining = false;
+		unsigned long int nbWritePktsSent = 0;
+		unsigned long int nbWritePktsDone = xbar->nbDroppedWrites;
+		for (unsigned int row(0); row < params.getRows(); ++row) {
+			for (unsigned int col(0); col < params.getCols(); ++col) {
+				draining = draining || pes[row][col]->hasCombinedWrites();
+				nbWritePktsSent += pes[row][col]->nbWritePktsSent;
+				nbWritePktsDone += pes[row][col]->nbWritePktsRcvd;
+			}
+		}
+		draining = draining || nbWritePktsDone < nbWritePktsSent;
+	}
+}
+
+/**
+ * SystemC thread switching the XBAR to its cycle-accurate model inside
+ * the windows of the hybrid fidelity and back to its functional model
+ * outside of them. It wakes up at the static windows boundaries and
+ * when a deadline miss opens a window.
+ */
+void dcSystem::fidelityController_thread() {
+	while (true) {
+		unsigned long int nowInNano = sc_time_stamp().value() / 1E3;
+		xbar->setFunctional(!fidelity->update(nowInNano));
+		unsigned long int nextInNano = fidelity->getNextChange(nowInNano);
+		if (nextInNano == 0) {
+			wait(fidelity->getDeadlineMissEvent());
+		} else {
+			wait(nextInNano - nowInNano, SC_NS,
+					fidelity->getDeadlineMissEvent());
+		}
+	}
+}
+
+/**
+ * SystemC thread running the DVFS governor of each clock domain at
+ * the end of every governor period, with the activity of the domain
+ * PEs during that period.
+ */
+void dcSystem::dvfsGovernor_thread() {
+
+	// Governor periods of a restored simulation start at the
+	// checkpoint time
+	if (restoreTimeInNano > 0) {
+		wait(restored_event);
+	}
+	while (true) {
+		wait(params.getDvfsPeriod(), SC_NS);
+		profiler.activated(simulationProfiler::DVFS_GOVERNOR);
+		unsigned long int nowInNano = sc_time_stamp().value() / 1E3;
+		for (vector<clockDomain_t>::iterator domain = clockDomains.begin();
+				domain != clockDomains.end(); ++domain) {
+
+			// Get activity of the domain and reset PE counters. The
+			// computation time of an instruction is counted when it
+			// ends, the part of it beyond the period of a PE is
+			// carried over to the next period so that the utilization
+			// stays between 0 and 1
+			domainActivity activity = { 0.0, 1.0, 0 };
+			unsigned long int busyTimeInNano = 0;
+			for (unsigned int i = 0; i < domain->pes.size(); i++) {
+				processingElement *pe = domain->pes[i];
+				unsigned long int peBusyTimeInNano = std::min(
+						pe->computationTime - domain->lastComputationTime[i],
+						params.getDvfsPeriod());
+				busyTimeInNano += peBusyTimeInNano;
+				domain->lastComputationTime[i] += peBusyTimeInNano;
+				if (pe->dvfsMinSlackRatio < activity.minSlackRatio) {
+					activity.minSlackRatio = pe->dvfsMinSlackRatio;
+				}
+				activity.nbDeadlinesMissed += pe->dvfsDeadlinesMissed;
+				pe->dvfsMinSlackRatio = 1.0;
+				pe->dvfsDeadlinesMissed = 0;
+			}
+			activity.utilization = (double) busyTimeInNano
+					/ (params.getDvfsPeriod() * domain->pes.size());
+
+			// Apply the operating point chosen by the governor
+			unsigned int next = governor->selectOperatingPoint(domain->current,
+					activity, domain->operatingPoints);
+			if (next == domain->current
+					|| next >= domain->operatingPoints.size()) {
+				continue;
+			}
+			operatingPoint &from = domain->operatingPoints[domain->current];
+			operatingPoint &to = domain->operatingPoints[next];
+			dvfsTransitionsCsvFile << nowInNano << "," << domain->id << ","
+					<< from.frequencyInHz << "," << to.frequencyInHz << ","
+					<< to.voltage << "," << activity.utilization << ","
+					<< activity.minSlackRatio << ","
+					<< activity.nbDeadlinesMissed << endl;
+			domain->residencyInNano[domain->current] += nowInNano
+					- domain->lastTransitionInNano;
+			domain->lastTransitionInNano = nowInNano;
+			domain->current = next;
+			domain->nbTransitions++;
+			for (vector<processingElement *>::iterator pe =
+					domain->pes.begin(); pe != domain->pes.end(); ++pe) {
+				(*pe)->setFrequencyInHz(to.frequencyInHz,
+						params.getDvfsLatency());
+			}
+		}
+	}
 }
 
 void dcSystem::stopSimu_thread() {
@@ -424,69 +1025,90 @@ void dcSystem::stopSimu_thread() {
 		}
 	}
 
+	// The application ends here, the writes left in the combining
+	// buffers are then sent so that they are part of the statistics
+	unsigned long int endTimeInNano = sc_time_stamp().value() / 1E3;
+	if (params.getWriteCombiningWindow() > 0) {
+		drainCombinedWrites();
+	}
+
 	// Get end time
 	clock_t end = std::clock();
+	stopProfilerPoller();
+
+	// The computation time and instructions of the PEs include the
+	// fast-forwarded hyperperiods, so does the execution time used for
+	// energy estimation
+	unsigned long int executionTimeInNano = endTimeInNano;
+	if (sampling != NULL) {
+		executionTimeInNano += (params.getNbHyperperiods()
+				- sampling->getNbSamples()) * hyperPeriod;
+	}
 
 	// Prints label access results
-	ofstream f(params.getOutputFolder() + "/labels.csv");
-	f << "PE,";
-	f << "Nb bytes for local reads,";
-	f << "Nb of local reads,";
-	f << "Nb bytes for local writes,";
-	f << "Nb of local writes,";
-	f << "Nb bytes for remote reads,";
-	f << "Nb of remote reads,";
-	f << "Nb bytes for remote writes,";
-	f << "Nb of remote write,";
-	f << "Total computation time" << endl;
-	unsigned int nbLocRds = 0;
-	unsigned int nbLocWrs = 0;
-	unsigned int nbRemRds = 0;
-	unsigned int nbRemWrs = 0;
-	unsigned long int bytesLocRds = 0;
-	unsigned long int bytesLocWrs = 0;
-	unsigned long int bytesRemRds = 0;
-	unsigned long int bytesRemWrs = 0;
-	unsigned long int computationTime = 0;
-	for (unsigned int row(0); row < params.getRows(); ++row) {
-		for (unsigned int col(0); col < params.getCols(); ++col) {
-			f << "PE" << row << col << ",";
-			f << pes[row][col]->bytesLocRds << ",";
-			f << pes[row][col]->nbLocRds << ",";
-			f << pes[row][col]->bytesLocWrs << ",";
-			f << pes[row][col]->nbLocWrs << ",";
-			f << pes[row][col]->bytesRemRds << ",";
-			f << pes[row][col]->nbRemRds << ",";
-			f << pes[row][col]->bytesRemWrs << ",";
-			f << pes[row][col]->nbRemWrs << ",";
-			f << pes[row][col]->computationTime << endl;
-			bytesLocRds += pes[row][col]->bytesLocRds;
-			bytesLocWrs += pes[row][col]->bytesLocWrs;
-			bytesRemRds += pes[row][col]->bytesRemRds;
-			bytesRemWrs += pes[row][col]->bytesRemWrs;
-			nbLocRds += pes[row][col]->nbLocRds;
-			nbLocWrs += pes[row][col]->nbLocWrs;
-			nbRemRds += pes[row][col]->nbRemRds;
-			nbRemWrs += pes[row][col]->nbRemWrs;
-			computationTime += pes[row][col]->computationTime;
-		}
-	}
-	f << "Total Nb bytes for local reads = " << bytesLocRds << endl;
-	f << "Total Nb of local reads = " << nbLocRds << endl;
-	f << "Total Nb bytes for local writes = " << bytesLocWrs << endl;
-	f << "Total Nb of local writes = " << nbLocWrs << endl;
-	f << "Total Nb bytes for remote reads = " << bytesRemRds << endl;
-	f << "Total Nb of remote reads = " << nbRemRds << endl;
-	f << "Total Nb bytes for remote writes = " << bytesRemWrs << endl;
-	f << "Total Nb of remote writes = " << nbRemWrs << endl;
-	f.close();
+	if (params.isOutputEnabled("labels")) {
+		ofstream f(params.getOutputFolder() + "/labels.csv");
+		f << "PE,";
+		f << "Nb bytes for local reads,";
+		f << "Nb of local reads,";
+		f << "Nb bytes for local writes,";
+		f << "Nb of local writes,";
+		f << "Nb bytes for remote reads,";
+		f << "Nb of remote reads,";
+		f << "Nb bytes for remote writes,";
+		f << "Nb of remote write,";
+		f << "Total computation time" << endl;
+		unsigned int nbLocRds = 0;
+		unsigned int nbLocWrs = 0;
+		unsigned int nbRemRds = 0;
+		unsigned int nbRemWrs = 0;
+		unsigned long int bytesLocRds = 0;
+		unsigned long int bytesLocWrs = 0;
+		unsigned long int bytesRemRds = 0;
+		unsigned long int bytesRemWrs = 0;
+		unsigned long int computationTime = 0;
+		for (unsigned int row(0); row < params.getRows(); ++row) {
+			for (unsigned int col(0); col < params.getCols(); ++col) {
+				f << "PE" << row << col << ",";
+				f << pes[row][col]->bytesLocRds << ",";
+				f << pes[row][col]->nbLocRds << ",";
+				f << pes[row][col]->bytesLocWrs << ",";
+				f << pes[row][col]->nbLocWrs << ",";
+				f << pes[row][col]->bytesRemRds << ",";
+				f << pes[row][col]->nbRemRds << ",";
+				f << pes[row][col]->bytesRemWrs << ",";
+				f << pes[row][col]->nbRemWrs << ",";
+				f << pes[row][col]->computationTime << endl;
+				bytesLocRds += pes[row][col]->bytesLocRds;
+				bytesLocWrs += pes[row][col]->bytesLocWrs;
+				bytesRemRds += pes[row][col]->bytesRemRds;
+				bytesRemWrs += pes[row][col]->bytesRemWrs;
+				nbLocRds += pes[row][col]->nbLocRds;
+				nbLocWrs += pes[row][col]->nbLocWrs;
+				nbRemRds += pes[row][col]->nbRemRds;
+				nbRemWrs += pes[row][col]->nbRemWrs;
+				computationTime += pes[row][col]->computationTime;
+			}
+		}
+		f << "Total Nb bytes for local reads = " << bytesLocRds << endl;
+		f << "Total Nb of local reads = " << nbLocRds << endl;
+		f << "Total Nb bytes for local writes = " << bytesLocWrs << endl;
+		f << "Total Nb of local writes = " << nbLocWrs << endl;
+		f << "Total Nb bytes for remote reads = " << bytesRemRds << endl;
+		f << "Total Nb of remote reads = " << nbRemRds << endl;
+		f << "Total Nb bytes for remote writes = " << bytesRemWrs << endl;
+		f << "Total Nb of remote writes = " << nbRemWrs << endl;
+		f.close();
+	}
+
+	// Print executed instructions for energy estimation
+	dumpInstructionsSummary();
 
 	// Print some results in a file for energy estimation
 	FILE *Parameters = fopen(
 			(params.getOutputFolder() + "/Parameters.txt").c_str(), "w+");
-	unsigned long int endTimeInNano = sc_time_stamp().value() / 1E3;
 	string timeString = static_cast<ostringstream*>(&(ostringstream()
-			<< endTimeInNano))->str();
+			<< executionTimeInNano))->str();
 	float systemFreq = 1.0 / params.getCoresPeriodInNano();
 	std::ostringstream freqVal;
 	freqVal << systemFreq;
@@ -509,7 +1131,11 @@ void dcSystem::stopSimu_thread() {
 				<< (nbRunnablesCompleted / runnables.size()) << endl;
 	}
 	cout << "    Execution time of the application             : "
-			<< endTimeInNano << " ns" << endl;
+			<< executionTimeInNano << " ns" << endl;
+	if (sampling != NULL) {
+		cout << "    Time simulated in detail                      : "
+				<< endTimeInNano << " ns" << endl;
+	}
 	int nbDeadlineMisses = 0;
 	for (unsigned int row(0); row < params.getRows(); ++row) {
 		for (unsigned int col(0); col < params.getCols(); ++col) {
@@ -523,6 +1149,11 @@ void dcSystem::stopSimu_thread() {
 			<< (xbar->GetTotalPacketExchanged()) << endl;
 	cout << "    Simulation time                               : "
 			<< (double) (end - start) / CLOCKS_PER_SEC << " s" << endl;
+	summary.endTimeInNano = executionTimeInNano;
+	summary.nbRunnablesCompleted = nbRunnablesCompleted;
+	summary.nbDeadlineMisses = nbDeadlineMisses;
+	summary.nbPackets = xbar->GetTotalPacketExchanged();
+	summary.simulationTimeInSec = (double) (end - start) / CLOCKS_PER_SEC;
 	string policy = "";
 	if (params.getXbarPolicy() == "Full") {
 		policy = "Full Duplex";
@@ -533,61 +1164,799 @@ void dcSystem::stopSimu_thread() {
 	}
 	cout << "    XBAR arbitration policy                       : " << policy
 			<< endl;
+	if (params.getXbarFidelity() != "accurate") {
+		cout << "    XBAR fidelity                                 : "
+				<< params.getXbarFidelity() << endl;
+		cout << "    Packets through the functional XBAR model     : "
+				<< xbar->nbFunctionalPackets << endl;
+		if (fidelity != NULL) {
+			fidelity->report(cout, endTimeInNano);
+		}
+	}
+	if (params.getNbMshrs() > 0) {
+		unsigned int nbPrefetches = 0;
+		unsigned int nbPrefetchHits = 0;
+		unsigned int nbPrefetchStalls = 0;
+		for (unsigned int row(0); row < params.getRows(); ++row) {
+			for (unsigned int col(0); col < params.getCols(); ++col) {
+				nbPrefetches += pes[row][col]->nbPrefetches;
+				nbPrefetchHits += pes[row][col]->nbPrefetchHits;
+				nbPrefetchStalls += pes[row][col]->nbPrefetchStalls;
+			}
+		}
+		cout << "    MSHRs per core                                : "
+				<< params.getNbMshrs() << endl;
+		cout << "    Remote reads issued ahead of use              : "
+				<< nbPrefetches << " (" << nbPrefetchHits
+				<< " completed before use, " << nbPrefetchStalls
+				<< " still in flight)" << endl;
+	}
+	if (params.getWriteCombiningWindow() > 0) {
+		unsigned int nbCombinedWrites = 0;
+		unsigned int nbCombinedWritePktsSent = 0;
+		unsigned int nbCombinedWritePktsSaved = 0;
+		for (unsigned int row(0); row < params.getRows(); ++row) {
+			for (unsigned int col(0); col < params.getCols(); ++col) {
+				nbCombinedWrites += pes[row][col]->nbCombinedWrites;
+				nbCombinedWritePktsSent +=
+						pes[row][col]->nbCombinedWritePktsSent;
+				nbCombinedWritePktsSaved +=
+						pes[row][col]->nbCombinedWritePktsSaved;
+			}
+		}
+		cout << "    Write combining window                        : "
+				<< params.getWriteCombiningWindow() << " ns" << endl;
+		cout << "    Remote writes combined                        : "
+				<< nbCombinedWrites << " (" << nbCombinedWritePktsSent
+				<< " packets sent, " << nbCombinedWritePktsSaved
+				<< " packets saved)" << endl;
+	}
+	if (params.getLabelCacheSize() > 0) {
+		unsigned int nbCacheHits = 0;
+		unsigned int nbCacheMisses = 0;
+		unsigned int nbCachePktsSaved = 0;
+		unsigned int nbCoherencePktsSent = 0;
+		for (unsigned int row(0); row < params.getRows(); ++row) {
+			for (unsigned int col(0); col < params.getCols(); ++col) {
+				nbCacheHits += pes[row][col]->nbCacheHits;
+				nbCacheMisses += pes[row][col]->nbCacheMisses;
+				nbCachePktsSaved += pes[row][col]->nbCachePktsSaved;
+				nbCoherencePktsSent += pes[row][col]->nbCoherencePktsSent;
+			}
+		}
+		cout << "    Label cache                                   : "
+				<< params.getLabelCacheSize() << " bytes, "
+				<< params.getLabelCacheWays() << " ways, "
+				<< (params.getLabelCacheCoherence() == "inv" ?
+						"write-invalidate" : "write-update") << endl;
+		cout << "    Label cache hits / misses                     : "
+				<< nbCacheHits << " / " << nbCacheMisses << " (hit rate "
+				<< (nbCacheHits + nbCacheMisses == 0 ?
+						0 : 100.0 * nbCacheHits / (nbCacheHits + nbCacheMisses))
+				<< " %)" << endl;
+		cout << "    Packets saved by label cache hits             : "
+				<< nbCachePktsSaved << " (" << nbCoherencePktsSent
+				<< " coherence packets sent)" << endl;
+	}
+	if (governor != NULL) {
+		unsigned int nbTransitions = 0;
+		unsigned long int transitionTime = 0;
+		ofstream residencyFile(
+				params.getOutputFolder() + "/OUTPUT_DVFS_Residency.csv");
+		residencyFile << "Clock_Domain,Frequency(Hz),Voltage,Time(NS)" << endl;
+		for (vector<clockDomain_t>::iterator domain = clockDomains.begin();
+				domain != clockDomains.end(); ++domain) {
+			domain->residencyInNano[domain->current] += endTimeInNano
+					- domain->lastTransitionInNano;
+			domain->lastTransitionInNano = endTimeInNano;
+			for (unsigned int i = 0; i < domain->operatingPoints.size(); i++) {
+				residencyFile << domain->id << ","
+						<< domain->operatingPoints[i].frequencyInHz << ","
+						<< domain->operatingPoints[i].voltage << ","
+						<< domain->residencyInNano[i] << endl;
+			}
+			nbTransitions += domain->nbTransitions;
+			for (vector<processingElement *>::iterator pe =
+					domain->pes.begin(); pe != domain->pes.end(); ++pe) {
+				transitionTime += (*pe)->dvfsTransitionTime;
+			}
+		}
+		residencyFile.close();
+		dvfsTransitionsCsvFile.close();
+		cout << "    DVFS governor                                 : "
+				<< params.getDvfsGovernor() << " (" << clockDomains.size()
+				<< " clock domains)" << endl;
+		cout << "    DVFS transitions                              : "
+				<< nbTransitions << " (" << transitionTime
+				<< " ns of PE stalls)" << endl;
+	}
+	cout << endl;
+	if (sampling != NULL) {
+		sampling->report(cout, params.getOutputFolder());
+	}
+	updateProfilerCounters();
+	profiler.printProfile(cout, endTimeInNano);
 
 	sc_stop();
 }
 
-void dcSystem::updateInstructionsExecTimeBounds(string newAppFile) {
+/**
+ * Parse each mode file once and store in each mode the parameters of
+ * the instructions that differ from the previous mode. Instructions
+ * are matched by their index in the application.
+ *
+ * With -modeCache, the deltas are saved in the cache folder and loaded
+ * from it by the next runs on the same files, which then don't parse
+ * the mode files. The application itself is always parsed.
+ */
+void dcSystem::buildModeDeltas() {
+	appInstructions = application->GetAllInstructions(taskGraph);
+	string cacheFile;
+	if (!params.getModeCacheFolder().empty()) {
+		cacheFile = params.getModeCacheFolder() + "/"
+				+ getModeDeltasCacheKey() + ".dcmd";
+		if (loadModeDeltasCache(cacheFile)) {
+			cout << "    Mode deltas loaded from " << cacheFile << endl;
+			return;
+		}
+	}
+	vector<instructionParams_t> current = getInstructionsParams(
+			appInstructions);
+	map<string, vector<instructionParams_t> > parsedModes;
+	unsigned int nbDeltas = 0;
+	for (vector<mode_t>::iterator mode = modes.begin(); mode != modes.end();
+			++mode) {
+		if (!mode->name.compare("end")) {
+			continue;
+		}
+		if (parsedModes.find(mode->file) == parsedModes.end()) {
+			dcAmaltheaParser amaltheaParser;
+			AmApplication* amApplication = new AmApplication();
+			amaltheaParser.ParseAmaltheaFile(mode->file, amApplication);
+			dcApplication *app = new dcApplication();
+			dcTaskGraph * modeGraph = app->createGraph("dcTaskGraph");
+			app->CreateGraphEntities(modeGraph, amApplication,
+					params.getSeqDep());
+			vector<dcInstruction *> modeInstructions = app->GetAllInstructions(
+					modeGraph);
+			if (modeInstructions.size() != appInstructions.size()) {
+				cerr << "error while parsing mode " << mode->name
+						<< ": instructions don't match the application"
+						<< endl;
+				exit(-1);
+			}
+			for (vector<dcInstruction *>::size_type i = 0;
+					i < modeInstructions.size(); i++) {
+				if (modeInstructions.at(i)->GetName()
+						!= appInstructions.at(i)->GetName()) {
+					cerr << "error while parsing mode " << mode->name
+							<< ": instructions don't match the application"
+							<< endl;
+					exit(-1);
+				}
+			}
+			parsedModes[mode->file] = getInstructionsParams(modeInstructions);
+			delete modeGraph;
+			delete app;
+			delete amApplication;
+		}
+		const vector<instructionParams_t> &next = parsedModes[mode->file];
+		for (vector<instructionParams_t>::size_type i = 0; i < next.size();
+				i++) {
+			const instructionParams_t &cur = current.at(i);
+			const instructionParams_t &nxt = next.at(i);
+			if (cur.value != nxt.value || cur.lowerBound != nxt.lowerBound
+					|| cur.upperBound != nxt.upperBound
+					|| cur.kappa != nxt.kappa || cur.lambda != nxt.lambda
+					|| cur.mean != nxt.mean
+					|| cur.remainPromille != nxt.remainPromille
+					|| cur.sd != nxt.sd) {
+				instructionDelta_t delta = { i, nxt };
+				mode->deltas.push_back(delta);
+			}
+		}
+		nbDeltas += mode->deltas.size();
+		current = next;
+	}
+	cout << "    Mode deltas: " << parsedModes.size() << " mode files, "
+			<< nbDeltas << " instruction changes" << endl;
+	if (!cacheFile.empty()) {
+		saveModeDeltasCache(cacheFile);
+	}
+}
 
-	// Parse new application
-	dcAmaltheaParser amaltheaParser;
-	AmApplication* amApplication = new AmApplication();
-	amaltheaParser.ParseAmaltheaFile(newAppFile, amApplication);
-	dcApplication *app = new dcApplication();
-	dcTaskGraph * taskGraph = app->createGraph("dcTaskGraph");
-	app->CreateGraphEntities(taskGraph, amApplication, params.getSeqDep());
+/**
+ * Return the FNV-1a hash of the content of the mode and application
+ * files and of the syntactic dependency flag, as an hexadecimal string.
+ */
+string dcSystem::getModeDeltasCacheKey() {
+	uint64_t hash = 0xCBF29CE484222325ULL;
+	vector<string> files;
+	files.push_back(params.getModeFile());
+	for (vector<mode_t>::iterator mode = modes.begin(); mode != modes.end();
+			++mode) {
+		files.push_back(mode->file);
+	}
+	for (vector<string>::iterator file = files.begin(); file != files.end();
+			++file) {
+		std::ifstream in(*file, ios::in | ios::binary);
+		char buffer[65536];
+		while (in.read(buffer, sizeof(buffer)) || in.gcount() > 0) {
+			for (std::streamsize i = 0; i < in.gcount(); i++) {
+				hash ^= static_cast<unsigned char>(buffer[i]);
+				hash *= 0x100000001B3ULL;
+			}
+		}
+	}
+	hash ^= params.getSeqDep() ? 1 : 0;
+	hash *= 0x100000001B3ULL;
+	ostringstream key;
+	key << hex << setw(16) << setfill('0') << hash;
+	return key.str();
+}
+
+// Layout of a mode deltas cache file:
+//   "DCMD", uint32 version, uint64 nb modes, uint64 nb instructions
+//   then for each mode: uint64 nb deltas and the delta records
+typedef struct {
+	uint64_t index;
+	int64_t value;
+	uint64_t deviation;
+	double lowerBound;
+	double upperBound;
+	double kappa;
+	double lambda;
+	double mean;
+	double remainPromille;
+	double sd;
+} modeDeltaRecord;
+const uint32_t MODE_DELTAS_CACHE_VERSION = 1;
+
+/**
+ * Read the deltas of all the modes from the given cache file. Return
+ * false, leaving the modes unchanged, if the file doesn't exist or
+ * doesn't match the application.
+ */
+bool dcSystem::loadModeDeltasCache(string cacheFile) {
+	ifstream f(cacheFile, ios::in | ios::binary);
+	if (!f) {
+		return false;
+	}
+	string content((std::istreambuf_iterator<char>(f)),
+			std::istreambuf_iterator<char>());
+	const char *data = content.data();
+	size_t size = content.size();
+	size_t headerSize = 4 + sizeof(uint32_t) + 2 * sizeof(uint64_t);
+	if (size < headerSize) {
+		return false;
+	}
+	uint32_t version;
+	uint64_t nbModes, nbInstructions;
+	memcpy(&version, data + 4, sizeof(version));
+	memcpy(&nbModes, data + 8, sizeof(nbModes));
+	memcpy(&nbInstructions, data + 16, sizeof(nbInstructions));
+	bool valid = !memcmp(data, "DCMD", 4)
+			&& version == MODE_DELTAS_CACHE_VERSION
+			&& nbModes == modes.size()
+			&& nbInstructions == appInstructions.size();
+	vector<vector<instructionDelta_t> > deltas(modes.size());
+	size_t offset = headerSize;
+	for (vector<mode_t>::size_type m = 0; valid && m < modes.size(); m++) {
+		uint64_t nbDeltas;
+		if (offset + sizeof(nbDeltas) > size) {
+			valid = false;
+			break;
+		}
+		memcpy(&nbDeltas, data + offset, sizeof(nbDeltas));
+		offset += sizeof(nbDeltas);
+		if (nbDeltas > (size - offset) / sizeof(modeDeltaRecord)) {
+			valid = false;
+			break;
+		}
+		deltas[m].reserve(nbDeltas);
+		for (uint64_t d = 0; d < nbDeltas; d++) {
+			modeDeltaRecord record;
+			memcpy(&record, data + offset, sizeof(record));
+			offset += sizeof(record);
+			if (record.index >= appInstructions.size()) {
+				valid = false;
+				break;
+			}
+			instructionDelta_t delta = { record.index, { record.deviation
+					!= 0, record.value, record.lowerBound, record.upperBound,
+					record.kappa, record.lambda, record.mean,
+					record.remainPromille, record.sd } };
+			deltas[m].push_back(delta);
+		}
+	}
+	if (!valid || offset != size) {
+		return false;
+	}
+	for (vector<mode_t>::size_type m = 0; m < modes.size(); m++) {
+		modes[m].deltas.swap(deltas[m]);
+	}
+	return true;
+}
+
+/**
+ * Write the deltas of all the modes in the given cache file.
+ */
+void dcSystem::saveModeDeltasCache(string cacheFile) {
+	// Write to a temporary file first so that concurrent runs never
+	// read a partially written cache
+	string tmpFile = cacheFile + "." + to_string(getpid());
+	ofstream f(tmpFile, ios::out | ios::binary);
+	uint64_t header[2] = { modes.size(), appInstructions.size() };
+	f.write("DCMD", 4);
+	f.write(reinterpret_cast<const char*>(&MODE_DELTAS_CACHE_VERSION),
+			sizeof(MODE_DELTAS_CACHE_VERSION));
+	f.write(reinterpret_cast<const char*>(header), sizeof(header));
+	for (vector<mode_t>::iterator mode = modes.begin(); mode != modes.end();
+			++mode) {
+		uint64_t nbDeltas = mode->deltas.size();
+		f.write(reinterpret_cast<const char*>(&nbDeltas), sizeof(nbDeltas));
+		for (vector<instructionDelta_t>::iterator delta =
+				mode->deltas.begin(); delta != mode->deltas.end(); ++delta) {
+			modeDeltaRecord record = { delta->index, delta->params.value,
+					delta->params.deviation ? 1ULL : 0ULL,
+					delta->params.lowerBound, delta->params.upperBound,
+					delta->params.kappa, delta->params.lambda,
+					delta->params.mean, delta->params.remainPromille,
+					delta->params.sd };
+			f.write(reinterpret_cast<const char*>(&record), sizeof(record));
+		}
+	}
+	f.close();
+	if (!f || rename(tmpFile.c_str(), cacheFile.c_str()) != 0) {
+		cerr << "cannot write mode deltas cache " << cacheFile << endl;
+		remove(tmpFile.c_str());
+	}
+}
 
-	// Compare and update instructions
+/**
+ * Return the execution parameters of the given instructions.
+ */
+vector<dcSystem::instructionParams_t> dcSystem::getInstructionsParams(
+		vector<dcInstruction *> &instructions) {
+	vector<instructionParams_t> instParams(instructions.size(),
+			instructionParams_t());
+	for (vector<dcInstruction *>::size_type i = 0; i < instructions.size();
+			i++) {
+		string instrName = instructions.at(i)->GetName();
+		if (instrName == "sw:InstructionsDeviation") {
+			dcExecutionCyclesDeviationInstruction *instDev =
+					static_cast<dcExecutionCyclesDeviationInstruction*>(instructions.at(
+							i));
+			instParams.at(i).deviation = true;
+			instParams.at(i).lowerBound = instDev->GetLowerBound();
+			instParams.at(i).upperBound = instDev->GetUpperBound();
+			instParams.at(i).kappa = instDev->GetKappa();
+			instParams.at(i).lambda = instDev->GetLambda();
+			instParams.at(i).mean = instDev->GetMean();
+			instParams.at(i).remainPromille = instDev->GetRemainPromille();
+			instParams.at(i).sd = instDev->GetSD();
+		}
+		if (instrName == "sw:InstructionsConstant") {
+			dcExecutionCyclesConstantInstruction *instCst =
+					static_cast<dcExecutionCyclesConstantInstruction*>(instructions.at(
+							i));
+			instParams.at(i).value = instCst->GetValue();
+		}
+	}
+	return instParams;
+}
+
+/**
+ * Patch the instructions changed by the given mode and their
+ * sampling parameters.
+ */
+void dcSystem::applyModeDeltas(const mode_t &mode) {
+	for (vector<instructionDelta_t>::const_iterator delta =
+			mode.deltas.begin(); delta != mode.deltas.end(); ++delta) {
+		dcInstruction *inst = appInstructions.at(delta->index);
+		if (delta->params.deviation) {
+			dcExecutionCyclesDeviationInstruction *instDev =
+					static_cast<dcExecutionCyclesDeviationInstruction*>(inst);
+			instDev->SetLowerBound(delta->params.lowerBound);
+			instDev->SetUpperBound(delta->params.upperBound);
+			instDev->SetKappa(delta->params.kappa);
+			instDev->SetLambda(delta->params.lambda);
+			instDev->SetMean(delta->params.mean);
+			instDev->SetRemainPromille(delta->params.remainPromille);
+			instDev->SetSD(delta->params.sd);
+			deviationParameters[inst] = computeDeviationParams(instDev);
+		} else if (inst->GetName() == "sw:InstructionsConstant") {
+			static_cast<dcExecutionCyclesConstantInstruction*>(inst)->SetValue(
+					delta->params.value);
+		}
+	}
+}
+
+/**
+ * Compute the sampling parameters of all the deviation instructions
+ * of the application, once instead of at each execution.
+ */
+void dcSystem::computeDeviationParameters() {
+	deviationParameters.clear();
 	vector<dcInstruction *> instructions = application->GetAllInstructions(
 			taskGraph);
-	vector<dcInstruction *> newInstructions = app->GetAllInstructions(
-			taskGraph);
-	for (vector<dcInstruction *>::size_type i = 0; i < instructions.size();
+	for (vector<dcInstruction *>::iterator it = instructions.begin();
+			it != instructions.end(); ++it) {
+		if ((*it)->GetName() == "sw:InstructionsDeviation") {
+			deviationParameters[*it] = computeDeviationParams(
+					static_cast<dcExecutionCyclesDeviationInstruction*>(*it));
+		}
+	}
+}
+
+/**
+ * SystemC thread saving a checkpoint at the time given by -checkpointAt.
+ */
+void dcSystem::checkpointer_thread() {
+	unsigned long int nowInNano = sc_time_stamp().value() / 1E3;
+	if (params.getCheckpointTime() < nowInNano) {
+		return;
+	}
+	wait(params.getCheckpointTime() - nowInNano, SC_NS);
+	saveCheckpoint();
+}
+
+/**
+ * Write the simulation state in CHECKPOINT_<time>.txt in the output
+ * folder. SystemC processes can't be saved in the middle of a wait,
+ * so the state is the one of the runnables and of the models:
+ *   - the released runnables, the mapper queues and the runnables
+ *     received by the PEs with their next instruction and times,
+ *   - the journal of the mapping heuristic calls,
+ *   - the periodic releases calendar and the dependency counters,
+ *   - the counters, random generators, label caches and DVFS state.
+ * Packets in the crossbar are not saved: blocked remote reads are
+ * issued again on restore, which also allows restoring with other
+ * crossbar parameters.
+ */
+void dcSystem::saveCheckpoint() {
+	unsigned long int nowInNano = sc_time_stamp().value() / 1E3;
+	string file = params.getOutputFolder() + "/CHECKPOINT_"
+			+ to_string(nowInNano) + ".txt";
+	ofstream f(file);
+	map<dcRunnableCall *, unsigned int> runnableIndexes;
+	for (vector<dcRunnableCall *>::size_type i = 0; i < runnables.size();
 			i++) {
-		dcInstruction *newInst = newInstructions.at(i);
-		dcInstruction *oldInst = instructions.at(i);
-		if (newInst->GetName() != oldInst->GetName()) {
-			cerr << "error while updating instructions execution time bounds"
-					<< endl;
+		runnableIndexes[runnables.at(i)] = i;
+	}
+
+	// Runnables sent to a PE which has not received them yet are
+	// sent again on restore
+	vector<pair<unsigned int, dcRunnableInstance *> > pending, sent;
+	for (unsigned int row(0); row < params.getRows(); ++row) {
+		for (unsigned int col(0); col < params.getCols(); ++col) {
+			unsigned int peIndex = row * params.getCols() + col;
+			if (pes[row][col]->newRunnableSignal) {
+				sent.push_back(
+						std::make_pair(peIndex, pes[row][col]->newRunnable));
+			}
+			if (peIndex < pendingRunnables.size()) {
+				for (std::deque<dcRunnableInstance*>::iterator it =
+						pendingRunnables[peIndex].begin();
+						it != pendingRunnables[peIndex].end(); ++it) {
+					pending.push_back(std::make_pair(peIndex, *it));
+				}
+			}
+		}
+	}
+
+	f << "checkpoint " << CHECKPOINT_VERSION << endl;
+	f << "time " << nowInNano << endl;
+	f << "application " << runnables.size() << " " << params.getSeqDep()
+			<< " " << params.getRows() << " " << params.getCols() << endl;
+	f << "counters " << nbRunnablesCompleted << " " << nbRunnablesMapped
+			<< " " << appIterations << " " << remainingNbRunnablesToMap << " "
+			<< currentMode << endl;
+	f << "enabledBy " << runnables.size();
+	for (vector<dcRunnableCall *>::iterator it = runnables.begin();
+			it != runnables.end(); ++it) {
+		f << " " << (*it)->GetEnabledBy();
+	}
+	f << endl;
+	std::priority_queue<calendarEntry_t, vector<calendarEntry_t>,
+			std::greater<calendarEntry_t> > calendar = releaseCalendar;
+	f << "calendar " << releaseGroups.size() << " " << calendar.size();
+	while (!calendar.empty()) {
+		f << " " << calendar.top().first << " " << calendar.top().second;
+		calendar.pop();
+	}
+	f << endl;
+	f << "released " << readyRunnables.size();
+	for (vector<dcRunnableInstance*>::iterator it = readyRunnables.begin();
+			it != readyRunnables.end(); ++it) {
+		f << " " << runnableIndexes[(*it)->getRunCall()] << " "
+				<< (*it)->GetReleaseTime();
+	}
+	f << endl;
+	f << "pending " << pending.size();
+	for (vector<pair<unsigned int, dcRunnableInstance *> >::iterator it =
+			pending.begin(); it != pending.end(); ++it) {
+		f << " " << it->first << " "
+				<< runnableIndexes[it->second->getRunCall()] << " "
+				<< it->second->GetReleaseTime();
+	}
+	f << endl;
+	f << "sent " << sent.size();
+	for (vector<pair<unsigned int, dcRunnableInstance *> >::iterator it =
+			sent.begin(); it != sent.end(); ++it) {
+		f << " " << it->first << " "
+				<< runnableIndexes[it->second->getRunCall()] << " "
+				<< it->second->GetReleaseTime() << " "
+				<< it->second->GetMappingTime();
+	}
+	f << endl;
+	f << "completed " << completedRunInstances.size();
+	for (vector<dcRunnableInstance*>::iterator it =
+			completedRunInstances.begin(); it != completedRunInstances.end();
+			++it) {
+		f << " " << runnableIndexes[(*it)->getRunCall()] << " "
+				<< (*it)->GetReleaseTime() << " " << (*it)->GetCompletionTime();
+	}
+	f << endl;
+	f << "mappings " << mappingCalls.size();
+	for (vector<mappingCall_t>::iterator it = mappingCalls.begin();
+			it != mappingCalls.end(); ++it) {
+		f << " " << it->type << " " << it->index << " " << it->periodId << " "
+				<< it->timeInPico;
+	}
+	f << endl;
+	f << "domains " << clockDomains.size() << endl;
+	for (vector<clockDomain_t>::iterator domain = clockDomains.begin();
+			domain != clockDomains.end(); ++domain) {
+		f << domain->current << " " << domain->lastTransitionInNano << " "
+				<< domain->nbTransitions << " "
+				<< domain->residencyInNano.size();
+		for (vector<unsigned long int>::iterator it =
+				domain->residencyInNano.begin();
+				it != domain->residencyInNano.end(); ++it) {
+			f << " " << *it;
+		}
+		f << endl;
+	}
+	for (unsigned int row(0); row < params.getRows(); ++row) {
+		for (unsigned int col(0); col < params.getCols(); ++col) {
+			pes[row][col]->saveState(f, runnableIndexes);
+		}
+	}
+	f << "end" << endl;
+	f.close();
+	cout << "    Checkpoint saved in " << file << endl;
+}
+
+/**
+ * Open the given checkpoint and read its time and application
+ * information, the state itself is read by restorer_thread.
+ */
+void dcSystem::openCheckpoint(string file) {
+	checkpointIn.open(file);
+	if (!checkpointIn) {
+		cerr << "cannot open checkpoint " << file << endl;
+		exit(-1);
+	}
+	unsigned int version, nbRunnables, rows, cols;
+	bool seqDep;
+	readCheckpointKey(checkpointIn, "checkpoint");
+	checkpointIn >> version;
+	if (version != CHECKPOINT_VERSION) {
+		cerr << "checkpoint version " << version << " is not supported"
+				<< endl;
+		exit(-1);
+	}
+	readCheckpointKey(checkpointIn, "time");
+	checkpointIn >> restoreTimeInNano;
+	readCheckpointKey(checkpointIn, "application");
+	checkpointIn >> nbRunnables >> seqDep >> rows >> cols;
+	if (nbRunnables != runnables.size() || seqDep != params.getSeqDep()
+			|| rows != params.getRows() || cols != params.getCols()) {
+		cerr << "checkpoint " << file
+				<< " was saved with another application or platform" << endl;
+		exit(-1);
+	}
+	if (restoreTimeInNano == 0) {
+		cerr << "checkpoint " << file << " is at time 0" << endl;
+		exit(-1);
+	}
+}
+
+/**
+ * Journal a call to the mapping heuristic if a checkpoint may be saved.
+ */
+void dcSystem::journalMappingCall(mappingCallType type, unsigned int index,
+		int periodId) {
+	if (journalMappingCalls) {
+		mappingCall_t call { type, index, periodId, sc_time_stamp().value() };
+		mappingCalls.push_back(call);
+	}
+}
+
+/**
+ * Call the mapping heuristic as the journaled calls of the restored
+ * simulation, so that it gets back to the same state. The runnables
+ * mapped are in the restored state already.
+ */
+void dcSystem::replayMappingCalls() {
+	for (vector<mappingCall_t>::iterator it = mappingCalls.begin();
+			it != mappingCalls.end(); ++it) {
+		if (it->type == MAP_RUNNABLE) {
+			dcRunnableCall *runCall = runnables.at(it->index);
+			mappingHeuristic->mapRunnable(it->timeInPico,
+					runCall->GetRunClassId(), runCall->GetRunClassName(),
+					runCall->GetTask()->GetName(), runCall->GetTask()->GetID(),
+					runCall->GetIdInTask(), it->periodId);
+		} else if (it->type == MAP_LABELS) {
+			mapLabels(it->timeInPico);
+		} else {
+			mappingHeuristic->switchMode(modes.at(it->index).time,
+					modes.at(it->index).file, modes.at(it->index).name);
+		}
+	}
+}
+
+/**
+ * SystemC thread restoring the state of the checkpoint. Nothing
+ * happens before the checkpoint time, so SystemC directly jumps to it.
+ */
+void dcSystem::restorer_thread() {
+	wait(restoreTimeInNano, SC_NS);
+	istream &is = checkpointIn;
+
+	unsigned int nbRunnables, nbGroups, nbEntries, runIndex, peIndex;
+	unsigned long int releaseTime, mappingTime, completionTime;
+	dcRunnableInstance *run;
+	readCheckpointKey(is, "counters");
+	is >> nbRunnablesCompleted >> nbRunnablesMapped >> appIterations
+			>> remainingNbRunnablesToMap >> currentMode;
+	if (!modes.empty() && currentMode >= modes.size()) {
+		cerr << "invalid checkpoint: unknown mode " << currentMode << endl;
+		exit(-1);
+	}
+	readCheckpointKey(is, "enabledBy");
+	is >> nbRunnables;
+	for (unsigned int i = 0; i < nbRunnables; i++) {
+		unsigned int enabledBy;
+		is >> enabledBy;
+		runnables.at(i)->SetEnabledBy(enabledBy);
+	}
+
+	readCheckpointKey(is, "calendar");
+	is >> nbGroups >> nbEntries;
+	if (nbGroups != releaseGroups.size()) {
+		cerr << "invalid checkpoint: " << nbGroups
+				<< " periodic release groups instead of "
+				<< releaseGroups.size() << endl;
+		exit(-1);
+	}
+	releaseCalendar = std::priority_queue<calendarEntry_t,
+			vector<calendarEntry_t>, std::greater<calendarEntry_t> >();
+	for (unsigned int i = 0; i < nbEntries; i++) {
+		calendarEntry_t entry;
+		is >> entry.first >> entry.second;
+		releaseCalendar.push(entry);
+	}
+
+	readCheckpointKey(is, "released");
+	is >> nbEntries;
+	for (unsigned int i = 0; i < nbEntries; i++) {
+		is >> runIndex >> releaseTime;
+		run = runInstancePool.create(runnables.at(runIndex));
+		run->SetReleaseTime(releaseTime);
+		readyRunnables.push_back(run);
+	}
+	readCheckpointKey(is, "pending");
+	is >> nbEntries;
+	for (unsigned int i = 0; i < nbEntries; i++) {
+		is >> peIndex >> runIndex >> releaseTime;
+		if (peIndex >= pendingRunnables.size()) {
+			cerr << "invalid checkpoint: unknown PE " << peIndex << endl;
 			exit(-1);
 		}
-		string instrName = newInst->GetName();
-		if (instrName == "sw:InstructionsDeviation") {
-			dcExecutionCyclesDeviationInstruction *newInstDev =
-					static_cast<dcExecutionCyclesDeviationInstruction*>(newInst);
-			dcExecutionCyclesDeviationInstruction *oldInstDev =
-					static_cast<dcExecutionCyclesDeviationInstruction*>(oldInst);
-			oldInstDev->SetLowerBound(newInstDev->GetLowerBound());
-			oldInstDev->SetUpperBound(newInstDev->GetUpperBound());
-			oldInstDev->SetKappa(newInstDev->GetKappa());
-			oldInstDev->SetLambda(newInstDev->GetLambda());
-			oldInstDev->SetMean(newInstDev->GetMean());
-			oldInstDev->SetRemainPromille(newInstDev->GetRemainPromille());
-			oldInstDev->SetSD(newInstDev->GetSD());
+		run = runInstancePool.create(runnables.at(runIndex));
+		run->SetReleaseTime(releaseTime);
+		pendingRunnables[peIndex].push_back(run);
+		pesWithPendingRunnables.insert(peIndex);
+	}
+	readCheckpointKey(is, "sent");
+	is >> nbEntries;
+	for (unsigned int i = 0; i < nbEntries; i++) {
+		is >> peIndex >> runIndex >> releaseTime >> mappingTime;
+		if (peIndex >= params.getDimension()) {
+			cerr << "invalid checkpoint: unknown PE " << peIndex << endl;
+			exit(-1);
 		}
-		if (instrName == "sw:InstructionsConstant") {
-			dcExecutionCyclesConstantInstruction *newInstCst =
-					static_cast<dcExecutionCyclesConstantInstruction*>(newInst);
-			dcExecutionCyclesConstantInstruction *oldInstCst =
-					static_cast<dcExecutionCyclesConstantInstruction*>(oldInst);
-			oldInstCst->SetValue(newInstCst->GetValue());
+		run = runInstancePool.create(runnables.at(runIndex));
+		run->SetReleaseTime(releaseTime);
+		run->SetMappingTime(mappingTime);
+		unsigned int x = peIndex / params.getCols();
+		unsigned int y = peIndex % params.getCols();
+		pes[x][y]->newRunnable = run;
+		pes[x][y]->newRunnableSignal = true;
+	}
+	readCheckpointKey(is, "completed");
+	is >> nbEntries;
+	for (unsigned int i = 0; i < nbEntries; i++) {
+		is >> runIndex >> releaseTime >> completionTime;
+		run = runInstancePool.create(runnables.at(runIndex));
+		run->SetReleaseTime(releaseTime);
+		run->SetCompletionTime(completionTime);
+		completedRunInstances.push_back(run);
+	}
+	readCheckpointKey(is, "mappings");
+	is >> nbEntries;
+	for (unsigned int i = 0; i < nbEntries; i++) {
+		int type;
+		mappingCall_t call;
+		is >> type >> call.index >> call.periodId >> call.timeInPico;
+		call.type = (mappingCallType) type;
+		if (!is || type > SWITCH_MODE
+				|| (type == MAP_RUNNABLE && call.index >= runnables.size())
+				|| (type == SWITCH_MODE && call.index >= modes.size())) {
+			cerr << "invalid checkpoint: bad mapping call " << i << endl;
+			exit(-1);
 		}
+		mappingCalls.push_back(call);
 	}
 
-	// Delete objects
-	delete taskGraph;
-	delete app;
-	delete amApplication;
+	unsigned int nbDomains;
+	readCheckpointKey(is, "domains");
+	is >> nbDomains;
+	if (nbDomains != clockDomains.size()) {
+		cerr << "invalid checkpoint: " << nbDomains
+				<< " clock domains instead of " << clockDomains.size() << endl;
+		exit(-1);
+	}
+	for (vector<clockDomain_t>::iterator domain = clockDomains.begin();
+			domain != clockDomains.end(); ++domain) {
+		unsigned int nbPoints;
+		is >> domain->current >> domain->lastTransitionInNano
+				>> domain->nbTransitions >> nbPoints;
+		if (nbPoints != domain->operatingPoints.size()
+				|| domain->current >= nbPoints) {
+			cerr << "invalid checkpoint: operating points of domain "
+					<< domain->id << " don't match" << endl;
+			exit(-1);
+		}
+		for (unsigned int i = 0; i < nbPoints; i++) {
+			is >> domain->residencyInNano[i];
+		}
+	}
+
+	for (unsigned int row(0); row < params.getRows(); ++row) {
+		for (unsigned int col(0); col < params.getCols(); ++col) {
+			pes[row][col]->restoreState(is, runnables, runInstancePool);
+		}
+	}
+	readCheckpointKey(is, "end");
+	checkpointIn.close();
+	replayMappingCalls();
+
+	// Restore DVFS frequencies and activity references
+	for (vector<clockDomain_t>::iterator domain = clockDomains.begin();
+			domain != clockDomains.end(); ++domain) {
+		for (unsigned int i = 0; i < domain->pes.size(); i++) {
+			domain->pes[i]->initFrequencyInHz(
+					domain->operatingPoints[domain->current].frequencyInHz);
+			domain->lastComputationTime[i] = domain->pes[i]->computationTime;
+		}
+	}
+
+	// Wake up the processes having restored work
+	for (unsigned int row(0); row < params.getRows(); ++row) {
+		for (unsigned int col(0); col < params.getCols(); ++col) {
+			newRunnable_event[row][col].notify();
+		}
+	}
+	if (!completedRunInstances.empty()) {
+		runnableCompleted_event.notify(SC_ZERO_TIME);
+	}
+	runnableReleased_event.notify();
+	restored_event.notify(SC_ZERO_TIME);
+	cout << "    Checkpoint restored at " << restoreTimeInNano << " ns"
+			<< endl;
 }
 
 }
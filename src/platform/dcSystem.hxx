@@ -15,9 +15,21 @@
 #include <iomanip>
 #include <vector>
 #include <map>
+#include <deque>
+#include <queue>
+#include <set>
 #include <ctime>
 #include <iostream>
+#include <thread>
+#include <atomic>
 #include "processingElement.hxx"
+#include "dvfsGovernor.hxx"
+#include "runnableInstancePool.hxx"
+#include "outputSink.hxx"
+#include "waveformWriter.hxx"
+#include "simulationProfiler.hxx"
+#include "hyperperiodSampler.hxx"
+#include "fidelityController.hxx"
 #include "xbar/packet.hxx"
 #include "dcConfiguration.hxx"
 #include "commons/parser/dcAmaltheaParser.h"
@@ -51,6 +63,23 @@ using std::vector;
 using namespace DCApplication;
 using namespace std;
 
+// AMALTHEA application parsed once and shared by the simulations of a
+// parameter sweep
+typedef struct parsedApplication {
+	AmApplication *amApplication;
+	dcApplication *application;
+	dcTaskGraph *taskGraph;
+} parsedApplication;
+
+// Main results of a simulation, merged in the table of a parameter sweep
+typedef struct simulationSummary {
+	unsigned long int endTimeInNano;
+	unsigned int nbRunnablesCompleted;
+	unsigned int nbDeadlineMisses;
+	unsigned int nbPackets;
+	double simulationTimeInSec;
+} simulationSummary;
+
 class dcSystem: sc_module {
 
 public:
@@ -58,7 +87,8 @@ public:
 	sc_in<bool> clock;
 
 	SC_HAS_PROCESS(dcSystem);
-	dcSystem(sc_module_name name, dcSimuParams params_) :
+	dcSystem(sc_module_name name, dcSimuParams params_,
+			const parsedApplication *parsed = NULL) :
 			sc_module(name), params(params_), pktsFromPe("pktFromPe",
 					params_.getRows()), pktsToPe("pktToPe", params_.getRows()), trReady(
 					"trReady", params_.getRows()), newPktFromPe("newPktFrompe",
@@ -82,69 +112,27 @@ public:
 		}
 
 // Open files
-		runnablesMappingCsvFile.open(params.getOutputFolder() + "/Mapping.csv");
-		runnablesCsvFile.open(
-				params.getOutputFolder() + "/OUTPUT_Runnable_Traces.csv");
-		runnablesCsvFile << fixed << setprecision(0);
-		runnablesCsvFile
-				<< "Core_ID,Runnable,Priority,Allocation_Time,Start_Time,Completion_Time,Duration,Deadline,Deadline_Met_Missed"
-				<< endl;
-		runnablesArffFile.open(
-				params.getOutputFolder() + "/OUTPUT_Runnable_Traces.arff");
-		runnablesArffFile << "@RELATION runnable" << endl << endl;
-		runnablesArffFile << "@ATTRIBUTE coreid           string" << endl;
-		runnablesArffFile << "@ATTRIBUTE id               string" << endl;
-		runnablesArffFile << "@ATTRIBUTE priority         NUMERIC" << endl;
-		runnablesArffFile << "@ATTRIBUTE alloctime        NUMERIC" << endl;
-		runnablesArffFile << "@ATTRIBUTE starttime        NUMERIC" << endl;
-		runnablesArffFile << "@ATTRIBUTE completiontime   NUMERIC" << endl;
-		runnablesArffFile << "@ATTRIBUTE duration         NUMERIC" << endl;
-		runnablesArffFile << "@ATTRIBUTE deadline         NUMERIC" << endl;
-		runnablesArffFile << "@ATTRIBUTE dealinemetmissed NUMERIC" << endl;
-		runnablesArffFile << endl << endl << "@DATA" << endl;
-		nocTrafficCsvFile.open(
-				params.getOutputFolder() + "/OUTPUT_NoC_Traces.csv");
-		nocTrafficCsvFile
-				<< "Packet ID,Priority,Read Request ID,Source,Destination,Injection Time(NS),Delivery Time(NS),Packet Latency(NS),Latency no Contention(NS)\n";
-		nocTrafficArffFile.open(
-				params.getOutputFolder() + "/OUTPUT_NoC_Traces.arff");
-		nocTrafficArffFile << "@RELATION packet" << endl << endl;
-		nocTrafficArffFile << "@ATTRIBUTE id            NUMERIC" << endl;
-		nocTrafficArffFile << "@ATTRIBUTE priority      NUMERIC" << endl;
-		nocTrafficArffFile << "@ATTRIBUTE info          NUMERIC" << endl;
-		nocTrafficArffFile << "@ATTRIBUTE source        string" << endl;
-		nocTrafficArffFile << "@ATTRIBUTE destination   string" << endl;
-		nocTrafficArffFile << "@ATTRIBUTE injectiontime NUMERIC" << endl;
-		nocTrafficArffFile << "@ATTRIBUTE deliverytime  NUMERIC" << endl;
-		nocTrafficArffFile << "@ATTRIBUTE latency       NUMERIC" << endl;
-		nocTrafficArffFile << "@ATTRIBUTE hoplatency    NUMERIC" << endl;
-		nocTrafficArffFile << endl << endl << "@DATA" << endl;
+		vector<string> outputs = params.getOutputs();
+		for (vector<string>::iterator it = outputs.begin();
+				it != outputs.end(); ++it) {
+			outputSink *sink = outputSink::create(*it,
+					params.getOutputFolder());
+			if (sink != NULL) {
+				sinks.add(sink);
+			}
+		}
 
 		if (params.getGenerateWaveforms()) {
-			runnablesVcdFile.open(
-					params.getOutputFolder() + "/OUTPUT_CORE_WAVE.vcd");
-			runnablesVcdFile << fixed << setprecision(0);
-			time_t rawtime;
-			struct tm * timeinfo;
-			char buffer[180];
-			time(&rawtime);
-			timeinfo = localtime(&rawtime);
-			strftime(buffer, 80, "%d-%m-%Y %I:%M:%S", timeinfo);
-			std::string str(buffer);
-			runnablesVcdFile << "$date " << str << " $end" << endl;
-			runnablesVcdFile << "$timescale 1 ns $end" << endl;
-			runnableWaveIDs =
-					fopen(
-							(params.getOutputFolder()
-									+ "/OUTPUT_RUNNABLE_IDs.csv").c_str(),
-							"w+");
-			fputs("ID , Runnable_Name , Task_Name\n", runnableWaveIDs);
-		}
-		constInstsCsvFile =
-				fopen(
-						(params.getOutputFolder()
-								+ "/Instruction_fixed_Power.txt").c_str(),
-						"w+");
+			waves = new waveformWriter(params.getOutputFolder(),
+					params.getWaveformFormat(),
+					params.getRows() * params.getCols(), params.getCols(),
+					params.getWaveformStart(), params.getWaveformEnd());
+		}
+		if (params.getInstructionsLog()) {
+			constInstsCsvFile = fopen(
+					(params.getOutputFolder() + "/Instruction_fixed_Power.txt").c_str(),
+					"w+");
+		}
 
 		// Get app file or mode file
 		string appPath;
@@ -152,6 +140,21 @@ public:
 			parseModeFile(params.getModeFile());
 			appPath = modes.front().file;
 			simulationEndFromMode = modes.back().time;
+
+			// A checkpoint at time 0 could not be restored
+			if (!params.getCheckpointMode().empty()) {
+				string checkpointMode = params.getCheckpointMode();
+				vector<mode_t>::iterator mode = std::find_if(modes.begin(),
+						modes.end(), [&checkpointMode](const mode_t &m) {
+							return m.name == checkpointMode;
+						});
+				if (mode == modes.end() || mode->time == 0) {
+					cerr << "-checkpointAtMode needs a mode switched to "
+							"after time 0: " << params.getCheckpointMode()
+							<< endl;
+					exit(-1);
+				}
+			}
 		} else {
 			appPath = params.getAppXml();
 			simulationEndFromCmdLine = params.getSimuEnd();
@@ -198,6 +201,16 @@ public:
 				<< endl;
 		cout << "    Cores operating frequency          : "
 				<< getFrequencyString(params.getCoresFrequencyInHz()) << endl;
+		if (!params.getPlatformFile().empty()) {
+			cout << "    Platform file                      : "
+					<< params.getPlatformFile() << endl;
+		}
+		if (!params.getDvfsGovernor().empty()) {
+			cout << "    DVFS governor                      : "
+					<< params.getDvfsGovernor() << " (period "
+					<< params.getDvfsPeriod() << " ns, transition "
+					<< params.getDvfsLatency() << " ns)" << endl;
+		}
 		cout << "    Mapping heuristic                  : "
 				<< params.getMappingHeuristic();
 		if (params.getMappingHeuristic() == "Static"
@@ -212,7 +225,16 @@ public:
 		cout << "    Syntactic dependency consideration : "
 				<< (params.getSeqDep() ? "true" : "false") << endl;
 		cout << "    Waveform  generation               : "
-				<< (params.getGenerateWaveforms() ? "true" : "false") << endl;
+				<< params.getWaveformFormat() << endl;
+		if (params.getNbHyperperiods() > 0) {
+			cout << "    Hyperperiod sampling               : "
+					<< params.getNbSampledHyperperiods() << " of "
+					<< params.getNbHyperperiods() << " hyperperiods" << endl;
+		}
+		if (params.getXbarFidelity() != "accurate") {
+			cout << "    XBAR fidelity                      : "
+					<< params.getXbarFidelity() << endl;
+		}
 
 //		cout << "    XBAR buffer size                    : " << params.getXbarBuffSize() << endl;
 //		cout << "    XBAR arbitration policy             : " << params.getXbarPolicy() << endl;
@@ -222,44 +244,29 @@ public:
 //		cout << "    XBAR remote write cost              : " << params.getRemoteWriteCost() << endl;
 		cout << endl << endl;
 
-		// Use the parser to create an AmApplication object
+		// Parse the application unless a parameter sweep shares it
 		int t0 = time(NULL);
-		dcAmaltheaParser amaltheaParser;
-		AmApplication* amApplication = new AmApplication();
-		amaltheaParser.ParseAmaltheaFile(appPath, amApplication);
-
-		// Assert we have the same instructionsPerCyle in
-		// all core types in the app because today we are
-		// only handling that case
-		map<string, dcCoreType*> coreTypes = amApplication->getCoreTypesMap();
-		typedef map<string, dcCoreType*>::iterator it_type;
-		int instructionsPerCycle = 1;
-		for (it_type iterator = coreTypes.begin(); iterator != coreTypes.end();
-				iterator++) {
-			if (instructionsPerCycle == 1) {
-				instructionsPerCycle =
-						iterator->second->GetInstructionsPerCycle();
-//			} else {
-//				if (iterator->second->GetInstructionsPerCycle()
-//						!= instructionsPerCycle) {
-//					cerr
-//							<< "different instructionsPerCycle values found in application"
-//							<< endl;
-//					exit(-1);
-//				}
-			}
-		}
-
-		// Convert the AmApplication to a dcApplication
-		application = new dcApplication();
-		taskGraph = application->createGraph("dcTaskGraph");
-		application->CreateGraphEntities(taskGraph, amApplication,
-				params.getSeqDep());
+		parsedApplication app =
+				parsed != NULL ?
+						*parsed : parseApplication(appPath, params.getSeqDep());
+		AmApplication* amApplication = app.amApplication;
+
+		// Get the type (frequency, CPI, clock domain) of each PE
+		// from the platform file or from the application core types
+		vector<processingElementType> peTypes = createPeTypes(amApplication);
+
+		// Get the application entities from its graph
+		application = app.application;
+		taskGraph = app.taskGraph;
 		tasks = application->GetAllTasks(taskGraph);
 		labels = application->GetAllLabels(amApplication);
 		runnables = application->GetAllRunnables(taskGraph);
 		application->dumpLabelAccesses(taskGraph, params.getOutputFolder());
 		application->dumpRunnablesToFiles(taskGraph, params.getOutputFolder());
+		computeDeviationParameters();
+		if (!modes.empty()) {
+			buildModeDeltas();
+		}
 
 		// Create mapping heuristic module
 		if (params.getMappingHeuristic() == "KhalidDC") {
@@ -322,41 +329,90 @@ public:
 				<< periodicAndSporadicRunnables.size() << " (hyper period = "
 				<< hyperPeriod << " ns)" << endl;
 		cout << "    Number of labels: " << labels.size() << endl;
+		cout << "    Number of core types: "
+				<< amApplication->getCoreTypesMap().size() << endl;
 //		cout << "    Number of instructions: "
 //				<< application->GetAllInstructions(taskGraph).size() << endl;
 		cout << "    Parsing time: " << (t1 - t0) << " s" << endl << endl
 				<< endl;
 
+		// Sampled hyperperiods are simulated back to back
+		if (params.getNbHyperperiods() > 0) {
+			if (hyperPeriod == 0) {
+				cerr << "-hyperperiods needs periodic runnables" << endl;
+				exit(-1);
+			}
+			sampling = new hyperperiodSampler(params.getNbHyperperiods(),
+					params.getNbSampledHyperperiods(), hyperPeriod,
+					params.getRows(), params.getCols());
+			sinks.add(sampling);
+			nbDetailedHyperperiods = sampling->getNbSamples();
+		}
+
+		// Cycle-accurate windows of the hybrid fidelity
+		if (params.getXbarFidelity() == "hybrid") {
+			vector<fidelityWindow> windows;
+			vector<pair<unsigned long int, unsigned long int> > userWindows =
+					params.getAccurateWindows();
+			for (vector<pair<unsigned long int, unsigned long int> >::iterator it =
+					userWindows.begin(); it != userWindows.end(); ++it) {
+				fidelityWindow window = { it->first, it->second, "window" };
+				windows.push_back(window);
+			}
+			if (params.getAccurateAroundModes()) {
+				for (vector<mode_t>::iterator it = modes.begin() + 1;
+						it != modes.end(); ++it) {
+					if (it->name == "end") {
+						continue;
+					}
+					unsigned long int before = std::min(it->time,
+							params.getAccurateBeforeMode());
+					fidelityWindow window = { it->time - before, it->time
+							+ params.getAccurateAfterMode(), "mode " + it->name };
+					windows.push_back(window);
+				}
+			}
+			fidelity = new fidelityController(windows,
+					params.getAccurateAfterMiss(), params.getOutputFolder());
+			sinks.add(fidelity);
+		}
+
 		vector<vector<dcRunnableCall *> > tasksToRunnables;
 		for (std::vector<dcTask *>::size_type i = 0; i < tasks.size(); i++) {
 			tasksToRunnables.push_back(
 					application->GetTaskRunnableCalls(taskGraph, tasks.at(i)));
 		}
 
-		if (params.getGenerateWaveforms()) {
-			int R_Index = 0;
-			for (std::vector<vector<dcRunnableCall *>>::size_type waveIndexT = 0;
-					waveIndexT < tasksToRunnables.size(); waveIndexT++) {
-				for (std::vector<dcRunnableCall *>::size_type waveIndexR = 0;
-						waveIndexR < tasksToRunnables.at(waveIndexT).size();
-						waveIndexR++) {
-					tasksToRunnables.at(waveIndexT).at(waveIndexR)->SetWaveID(
-							R_Index);
-					string R_Name = tasksToRunnables.at(waveIndexT).at(
-							waveIndexR)->GetRunClassName();
-					std::string s = std::to_string(R_Index);
-					std::string ID_R = s + " , " + R_Name + " , "
-							+ tasks.at(waveIndexT)->GetName() + "\n";
-					const char* wave_temp_dump = ID_R.c_str();
-					fputs(wave_temp_dump, runnableWaveIDs);
-					R_Index++;
-				}
+		// Runnable ids used in the waveforms and by the energy estimation
+		FILE *runnableWaveIDs = fopen(
+				(params.getOutputFolder() + "/OUTPUT_RUNNABLE_IDs.csv").c_str(),
+				"w+");
+		fputs("ID , Runnable_Name , Task_Name\n", runnableWaveIDs);
+		int R_Index = 0;
+		for (std::vector<vector<dcRunnableCall *>>::size_type waveIndexT = 0;
+				waveIndexT < tasksToRunnables.size(); waveIndexT++) {
+			for (std::vector<dcRunnableCall *>::size_type waveIndexR = 0;
+					waveIndexR < tasksToRunnables.at(waveIndexT).size();
+					waveIndexR++) {
+				tasksToRunnables.at(waveIndexT).at(waveIndexR)->SetWaveID(
+						R_Index);
+				string R_Name = tasksToRunnables.at(waveIndexT).at(
+						waveIndexR)->GetRunClassName();
+				std::string s = std::to_string(R_Index);
+				std::string ID_R = s + " , " + R_Name + " , "
+						+ tasks.at(waveIndexT)->GetName() + "\n";
+				const char* wave_temp_dump = ID_R.c_str();
+				fputs(wave_temp_dump, runnableWaveIDs);
+				R_Index++;
 			}
 		}
+		fclose(runnableWaveIDs);
 
 		// Dump graph files
-		dumpTaskGraphFile();
-		dumpTaskAndRunnableGraphFile();
+		if (params.isOutputEnabled("graphs")) {
+			dumpTaskGraphFile();
+			dumpTaskAndRunnableGraphFile();
+		}
 
 		// Initialize some signals
 		for (unsigned int row(0); row < params.getRows(); ++row) {
@@ -366,42 +422,6 @@ public:
 			}
 		}
 
-		// Define VCD signals
-		for (unsigned int row(0); row < params.getRows(); ++row) {
-			for (unsigned int col(0); col < params.getCols(); ++col) {
-				if (params.getGenerateWaveforms()) {
-					runnablesVcdFile << "$var wire 12 " << VCD_ACTIVE_RUN_ID
-							<< row << col << " ACTIVE_RUNNABLE_ID-PE" << row
-							<< col << " $end\n";
-					runnablesVcdFile << "$var event 1 "
-							<< VCD_SUSPENDED_ON_REQUEST << row << col
-							<< " SUSPENDED_ON_REQUEST-PE" << row << col
-							<< " $end\n";
-					runnablesVcdFile << "$var event 1 " << VCD_PREEMPTION << row
-							<< col << " PREEMPTION-PE" << row << col
-							<< " $end\n";
-					runnablesVcdFile << "$var event 1 "
-							<< VCD_RUNNABLE_COMPLETED << row << col
-							<< " RUNNABLE_COMPLETED-PE" << row << col
-							<< " $end\n";
-					runnablesVcdFile << "$var event 1 " << VCD_DEADLINE_MISSED
-							<< row << col << " DEADLINE_MISSED-PE" << row << col
-							<< " $end\n";
-				}
-			}
-		}
-
-		// Init VCD signals
-		if (params.getGenerateWaveforms()) {
-			runnablesVcdFile << "$upscope $end\n$enddefinitions $end\n";
-			for (unsigned int row(0); row < params.getRows(); ++row) {
-				for (unsigned int col(0); col < params.getCols(); ++col) {
-					runnablesVcdFile << "#0" << " " << VCD_12_UNDEF << " "
-							<< VCD_ACTIVE_RUN_ID << row << col << endl;
-				}
-			}
-		}
-
 		// Adjusting dimension of the Processing Element (PE) table
 		pes.resize(params.getRows());
 		for (unsigned int row(0); row < params.getRows(); ++row) {
@@ -416,18 +436,23 @@ public:
 				name << "PE(" << row << "," << col << ")";
 
 				pes[row][col] = new processingElement(name.str().c_str(),
-						constInstsCsvFile, &nocTrafficCsvFile,
-						&nocTrafficArffFile, &runnablesCsvFile,
-						&runnablesArffFile, &runnablesVcdFile, sched, params,
-						instructionsPerCycle);
+						constInstsCsvFile, &sinks, waves, sched,
+						params,
+						peTypes.at(row * params.getCols() + col));
 				pes[row][col]->x_PE = row;
 				pes[row][col]->y_PE = col;
 				pes[row][col]->canReceivePkt_signal(trReady[row][col]);
 				pes[row][col]->newPacket_signal(newPktFromPe[row][col]);
 				pes[row][col]->runnableCompleted_event =
 						&runnableCompleted_event;
+				pes[row][col]->runnableConsumed_event =
+						&runnableConsumed_event;
+				pes[row][col]->completedRunInstances = &completedRunInstances;
 				pes[row][col]->packetToSend_event = &packetToSend_event;
 				pes[row][col]->newRunnable_event = &newRunnable_event[row][col];
+				pes[row][col]->labelSharers = &labelSharers;
+				pes[row][col]->deviationParameters = &deviationParameters;
+				pes[row][col]->profiler = &profiler;
 
 				pes[row][col]->pe_inputs(sig_inp.at(counter));
 				pes[row][col]->pe_outputs(sig_out.at(counter));
@@ -436,6 +461,11 @@ public:
 			}
 		}
 
+		// Group the PEs in clock domains for DVFS
+		if (!params.getDvfsGovernor().empty()) {
+			createClockDomains();
+		}
+
 		// Creating the XBAR interconnect
 		xbar = new XBAR("XBAR", params_);
 		xbar->clk(clock);
@@ -456,28 +486,73 @@ public:
 		sensitive << runnableCompleted_event;
 		dont_initialize();
 		SC_THREAD(periodicRunnablesReleaser_thread);
+		if (params.getProfile()) {
+			simulationProfiler::installSnapshotHandler();
+			profilerPoller = std::thread(&dcSystem::pollProfiler, this);
+		}
 		SC_METHOD(nonPeriodicIndependentRunnablesReleaser_method);
 		sensitive << iteration_event;
+		if (!params.getRestoreFile().empty()) {
+			// Independent runnables are part of the restored state
+			dont_initialize();
+		}
+
+		// Start checkpointing threads if required
+		journalMappingCalls = params.getCheckpointTime() > 0
+				|| !params.getCheckpointMode().empty();
+		if (params.getCheckpointTime() > 0) {
+			SC_THREAD(checkpointer_thread);
+		}
+		if (!params.getRestoreFile().empty()) {
+			openCheckpoint(params.getRestoreFile());
+			SC_THREAD(restorer_thread);
+		}
 
-		// Start mode switching thread if required
+		// Start hyperperiod sampling thread if required
+		if (sampling != NULL) {
+			SC_THREAD(hyperperiodSampler_thread);
+		}
+
+		// Start XBAR fidelity switching thread if required
+		if (fidelity != NULL) {
+			SC_THREAD(fidelityController_thread);
+		}
+
+		// Start DVFS governor thread if required
+		if (governor != NULL) {
+			SC_THREAD(dvfsGovernor_thread);
+		}
+
+		// Start mode switching thread if required, a restored
+		// simulation replays the labels mapping instead
 		if (simulationEndFromMode != 0) {
 			SC_THREAD(modeSwitcher_thread);
-		} else {
+		} else if (params.getRestoreFile().empty()) {
 			SC_METHOD(labelsMapper_method);
 		}
 	}
 
 	inline ~dcSystem() {
-		runnablesCsvFile.close();
-		runnablesArffFile.close();
-		runnablesMappingCsvFile.close();
-		nocTrafficArffFile.close();
-		nocTrafficCsvFile.close();
-		if (params.getGenerateWaveforms()) {
-			runnablesVcdFile << "#" << (sc_time_stamp().value() * 1E-3) << endl;
-			runnablesVcdFile.close();
+		stopProfilerPoller();
+		if (waves != NULL) {
+			waves->close(sc_time_stamp().value());
+			delete waves;
+		}
+		if (constInstsCsvFile != NULL) {
+			fclose(constInstsCsvFile);
 		}
 		delete mappingHeuristic;
+		delete governor;
+	}
+
+	// Parse the given AMALTHEA file and create its graph
+	static parsedApplication parseApplication(string appPath, bool seqDep);
+
+	// Return the application file given by -a or by the first mode of -f
+	static string getApplicationFile(dcSimuParams &params);
+
+	const simulationSummary &getSummary() const {
+		return summary;
 	}
 
 	// Types definitions
@@ -514,14 +589,27 @@ private:
 	void periodicRunnablesReleaser_thread();
 	void nonPeriodicIndependentRunnablesReleaser_method();
 	void modeSwitcher_thread();
+	void dvfsGovernor_thread();
+	void checkpointer_thread();
+	void restorer_thread();
+	void hyperperiodSampler_thread();
+	void fidelityController_thread();
 
 	// Utility functions
 	void dumpNoCLoadGraphFile();
 	void dumpTraces();
 	void dumpTaskGraphFile();
 	void dumpTaskAndRunnableGraphFile();
+	void dumpInstructionsSummary();
 	void parseModeFile(string file);
-	void updateInstructionsExecTimeBounds(string newAppFile);
+	vector<processingElementType> createPeTypes(AmApplication *amApplication);
+	unsigned long int parsePlatformNumber(string value, string field);
+	vector<operatingPoint> parseDvfsTable(string file);
+	void createClockDomains();
+	void computeDeviationParameters();
+	void saveCheckpoint();
+	void drainCombinedWrites();
+	void openCheckpoint(string file);
 	string getFrequencyString(unsigned long int freqInHertz);
 
 	// Function used to release a runnable and wake up the mapper.
@@ -537,19 +625,63 @@ private:
 
 	peTable pes;
 	vector<labelMapping> mappingTable;
+	labelSharersTable labelSharers;
+	deviationParamsTable deviationParameters;
 	dcSimuParams params;
 	static int bufferSize;
 
-	// Modes management
+	// Modes management: all the mode files are parsed once at startup
+	// and each mode keeps only the instructions it changes compared to
+	// the previous mode, so that a switch only patches these ones
+	typedef struct {
+		bool deviation;
+		long int value; // constant instructions
+		double lowerBound;
+		double upperBound;
+		double kappa;
+		double lambda;
+		double mean;
+		double remainPromille;
+		double sd;
+	} instructionParams_t;
+	typedef struct {
+		vector<dcInstruction *>::size_type index; // in appInstructions
+		instructionParams_t params;
+	} instructionDelta_t;
 	typedef struct {
 		unsigned long int time;
 		string name;
 		string file;
+		vector<instructionDelta_t> deltas;
 	} mode_t;
 	vector<mode_t> modes;
+	vector<dcInstruction *> appInstructions;
+	void buildModeDeltas();
+	string getModeDeltasCacheKey();
+	bool loadModeDeltasCache(string cacheFile);
+	void saveModeDeltasCache(string cacheFile);
+	vector<instructionParams_t> getInstructionsParams(
+			vector<dcInstruction *> &instructions);
+	void applyModeDeltas(const mode_t &mode);
 	unsigned long int simulationEndFromMode = 0;
 	unsigned long int simulationEndFromCmdLine;
 
+	// DVFS management: all the PEs of a clock domain run at the
+	// operating point chosen by the governor for this domain
+	typedef struct {
+		unsigned int id;
+		vector<processingElement *> pes;
+		vector<unsigned long int> lastComputationTime; // per PE, in ns
+		vector<operatingPoint> operatingPoints; // by increasing frequency
+		unsigned int current;
+		vector<unsigned long int> residencyInNano; // per operating point
+		unsigned long int lastTransitionInNano;
+		unsigned int nbTransitions;
+	} clockDomain_t;
+	vector<clockDomain_t> clockDomains;
+	dvfsGovernor *governor = NULL;
+	ofstream dvfsTransitionsCsvFile;
+
 	// Communication medium interface
 	sc_vector<sc_vector<sc_signal<Packet> > > pktsFromPe;
 	sc_vector<sc_vector<sc_buffer<Packet> > > pktsToPe;
@@ -557,14 +689,9 @@ private:
 	sc_vector<sc_vector<sc_signal<bool> > > newPktFromPe;
 
 	// Output files
-	ofstream nocTrafficCsvFile;
-	ofstream nocTrafficArffFile;
-	FILE* constInstsCsvFile;
-	FILE* runnableWaveIDs;
-	ofstream runnablesCsvFile;
-	ofstream runnablesArffFile;
-	ofstream runnablesMappingCsvFile;
-	ofstream runnablesVcdFile;
+	outputSinks sinks;
+	FILE* constInstsCsvFile = NULL;
+	waveformWriter *waves = NULL;
 
 	// Amalthea application
 	dcTaskGraph* taskGraph;
@@ -572,15 +699,66 @@ private:
 	vector<dcTask*> tasks;
 	vector<dcLabel*> labels;
 
+	// Storage of all the runnable instances, recycled on completion
+	runnableInstancePool runInstancePool;
+
 	// List of released runnable instances
 	vector<dcRunnableInstance*> readyRunnables;
 
+	// Runnable instances completed by the PEs since the last
+	// call to dependentRunnablesReleaser_method
+	vector<dcRunnableInstance*> completedRunInstances;
+
+	// Runnable instances mapped on each PE (row major order) and not yet
+	// sent to it, and the PEs having some
+	vector<std::deque<dcRunnableInstance*> > pendingRunnables;
+	std::set<unsigned int> pesWithPendingRunnables;
+	int appIterations = 0;
+	int remainingNbRunnablesToMap = 0;
+
 	// List of application runnable calls
 	vector<dcRunnableCall*> runnables;
 
-	// Management of periodic runnables
+	// Management of periodic runnables: runnables sharing the same
+	// period and offset are released together by a group, the next
+	// release time of each group is kept in a min-heap calendar
 	vector<dcRunnableCall*> periodicAndSporadicRunnables;
 	unsigned long hyperPeriod;
+	typedef struct {
+		unsigned long int periodInNano;
+		vector<unsigned int> runnables; // indexes in periodicAndSporadicRunnables
+	} releaseGroup_t;
+	vector<releaseGroup_t> releaseGroups;
+	unsigned long int nbDetailedHyperperiods = 1; // before stopping without -simuEnd
+	typedef pair<unsigned long int, unsigned int> calendarEntry_t; // next release time, group
+	std::priority_queue<calendarEntry_t, vector<calendarEntry_t>,
+			std::greater<calendarEntry_t> > releaseCalendar;
+
+	// Checkpointing: the state is saved at a given time or mode switch,
+	// a restored simulation idles until the checkpoint time, where
+	// restorer_thread loads the state and notifies restored_event
+	ifstream checkpointIn;
+	unsigned long int restoreTimeInNano = 0;
+	sc_event restored_event;
+	vector<mode_t>::size_type currentMode = 0;
+
+	// The mapping heuristic can't save its state, so its calls are
+	// journaled when checkpointing and replayed on restore
+	typedef enum {
+		MAP_RUNNABLE, MAP_LABELS, SWITCH_MODE
+	} mappingCallType;
+	typedef struct {
+		mappingCallType type;
+		unsigned int index; // runnable index or mode index
+		int periodId;
+		unsigned long int timeInPico;
+	} mappingCall_t;
+	vector<mappingCall_t> mappingCalls;
+	bool journalMappingCalls = false;
+	void journalMappingCall(mappingCallType type, unsigned int index,
+			int periodId);
+	void replayMappingCalls();
+	void mapLabels(unsigned long int timeInPico);
 
 	// Runnable Mapper and NoC handshake signals.
 	sc_vector<sc_vector<sc_event> > newRunnable_event;
@@ -594,6 +772,7 @@ private:
 
 	// Event used by processing elements to notify mapper
 	sc_event runnableCompleted_event; // when a runnable is completed
+	sc_event runnableConsumed_event; // when a runnable sent by the mapper has been received
 	sc_event packetToSend_event; // when a packet need to be send
 
 	// Event used to notify the nonPeriodicRunnableReleaser method on each new iteration
@@ -602,6 +781,28 @@ private:
 	// Simulation start time
 	clock_t start;
 
+	// Statistical sampling of the hyperperiods, owned by sinks, NULL
+	// without -hyperperiods
+	hyperperiodSampler *sampling = NULL;
+
+	// Cycle-accurate windows of the XBAR, owned by sinks, NULL unless
+	// the fidelity is hybrid
+	fidelityController *fidelity = NULL;
+
+	// Simulator performance counters
+	simulationProfiler profiler;
+	void updateProfilerCounters();
+
+	// Host thread answering the progress and snapshot requests on the
+	// wall clock, also while the simulated time doesn't advance
+	std::thread profilerPoller;
+	std::atomic<bool> profilerStopped { false };
+	void pollProfiler();
+	void stopProfilerPoller();
+
+	// Filled at the end of the simulation
+	simulationSummary summary = simulationSummary();
+
 	static xb_sc_fifo<Packet>*
 	create_fifo(const char* nm, size_t) {
 		return new xb_sc_fifo<Packet>(nm, bufferSize);
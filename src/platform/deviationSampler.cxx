@@ -0,0 +1,224 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//                           DREAMCLOUD PROJECT                               //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////
+//    INCLUDES    //
+////////////////////
+#include "deviationSampler.hxx"
+#include <cmath>
+#include <limits>
+#include <cstring>
+
+namespace dreamcloud {
+namespace platform_sclib {
+
+// Number of draws outside the bounds before clamping the sample
+const unsigned int MAX_REJECTED_SAMPLES = 16;
+
+/**
+ * Shape of the Weibull distribution of the given mean having
+ * remainPromille per mille of its samples above the upper bound (the
+ * AMALTHEA Weibull estimators). The probability to be above the bound
+ * decreases with the shape from the exponential one (shape 1), the
+ * shape is searched by bisection between 1 and 1000.
+ */
+static double estimateWeibullKappa(double mean, double upperBound,
+		double remainPromille) {
+	double remain = remainPromille / 1000.0;
+	double low = 1.0;
+	double high = 1000.0;
+	for (unsigned int i = 0; i < 64; i++) {
+		double kappa = std::sqrt(low * high);
+		double lambda = mean / std::tgamma(1.0 + 1.0 / kappa);
+		if (std::exp(-std::pow(upperBound / lambda, kappa)) > remain) {
+			low = kappa;
+		} else {
+			high = kappa;
+		}
+	}
+	return low;
+}
+
+deviationParams computeDeviationParams(
+		dcExecutionCyclesDeviationInstruction *inst) {
+	deviationParams params;
+	params.lowerBound = inst->GetLowerBoundValid() ? inst->GetLowerBound() : 0;
+	params.upperBound =
+			inst->GetUpperBoundValid() ?
+					inst->GetUpperBound() :
+					std::numeric_limits<double>::infinity();
+	params.mean = inst->GetMean();
+	params.sd = inst->GetSD();
+	params.lambda = 0;
+	params.invKappa = 0;
+	if (inst->GetKappa() > 0) {
+		params.kind = deviationParams::WEIBULL;
+		params.invKappa = 1.0 / inst->GetKappa();
+		params.lambda = inst->GetLambda();
+		if (params.lambda <= 0) {
+			// Scale giving the expected mean
+			params.lambda = params.mean / std::tgamma(1.0 + params.invKappa);
+		}
+	} else if (inst->GetRemainPromille() > 0 && inst->GetUpperBoundValid()
+			&& params.mean > 0 && params.mean < params.upperBound) {
+		params.kind = deviationParams::WEIBULL;
+		params.invKappa = 1.0
+				/ estimateWeibullKappa(params.mean, params.upperBound,
+						inst->GetRemainPromille());
+		params.lambda = params.mean / std::tgamma(1.0 + params.invKappa);
+	} else if (params.sd > 0) {
+		params.kind = deviationParams::NORMAL;
+	} else {
+		params.kind = deviationParams::UNIFORM;
+		if (!inst->GetUpperBoundValid()) {
+			params.upperBound = params.lowerBound;
+		}
+	}
+	if (params.upperBound < params.lowerBound) {
+		params.upperBound = params.lowerBound;
+	}
+	return params;
+}
+
+uniformBatchGenerator::uniformBatchGenerator(uint64_t seed) {
+	// Seed the lanes with splitmix64 so that they never start at 0
+	for (unsigned int lane = 0; lane < NB_LANES; lane++) {
+		seed += 0x9E3779B97F4A7C15ULL;
+		uint64_t z = seed;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		state[lane] = (z ^ (z >> 31)) | 1;
+	}
+	refill();
+}
+
+void uniformBatchGenerator::refill() {
+	for (unsigned int i = 0; i < BATCH_SIZE; i += NB_LANES) {
+		for (unsigned int lane = 0; lane < NB_LANES; lane++) {
+			uint64_t x = state[lane];
+			x ^= x >> 12;
+			x ^= x << 25;
+			x ^= x >> 27;
+			state[lane] = x;
+			// 53 upper bits mapped to the middle of one of 2^53 intervals
+			buffer[i + lane] = ((x * 0x2545F4914F6CDD1DULL) >> 11)
+					* (1.0 / 9007199254740992.0) + (0.5 / 9007199254740992.0);
+		}
+	}
+	index = 0;
+}
+
+void uniformBatchGenerator::saveState(std::ostream &os) const {
+	for (unsigned int lane = 0; lane < NB_LANES; lane++) {
+		os << state[lane] << " ";
+	}
+	os << index;
+	for (unsigned int i = 0; i < BATCH_SIZE; i++) {
+		uint64_t bits;
+		memcpy(&bits, &buffer[i], sizeof(bits));
+		os << " " << bits;
+	}
+}
+
+void uniformBatchGenerator::restoreState(std::istream &is) {
+	for (unsigned int lane = 0; lane < NB_LANES; lane++) {
+		is >> state[lane];
+	}
+	is >> index;
+	for (unsigned int i = 0; i < BATCH_SIZE; i++) {
+		uint64_t bits;
+		is >> bits;
+		memcpy(&buffer[i], &bits, sizeof(bits));
+	}
+	if (index > BATCH_SIZE) {
+		index = BATCH_SIZE;
+	}
+}
+
+deviationSampler::deviationSampler(uint64_t seed) :
+		uniforms(seed), spareNormal(0), hasSpareNormal(false) {
+}
+
+unsigned long int deviationSampler::sample(const deviationParams &params) {
+	double value;
+	switch (params.kind) {
+	case deviationParams::NORMAL:
+		value = sampleNormal(params);
+		break;
+	case deviationParams::WEIBULL:
+		value = sampleWeibull(params);
+		break;
+	default:
+		value = params.lowerBound
+				+ std::floor(
+						uniforms.next()
+								* (params.upperBound - params.lowerBound + 1));
+		break;
+	}
+	if (value < params.lowerBound) {
+		value = params.lowerBound;
+	} else if (value > params.upperBound) {
+		value = params.upperBound;
+	}
+	return std::llround(value);
+}
+
+void deviationSampler::saveState(std::ostream &os) const {
+	uint64_t spareBits;
+	memcpy(&spareBits, &spareNormal, sizeof(spareBits));
+	os << hasSpareNormal << " " << spareBits << " ";
+	uniforms.saveState(os);
+}
+
+void deviationSampler::restoreState(std::istream &is) {
+	uint64_t spareBits;
+	is >> hasSpareNormal >> spareBits;
+	memcpy(&spareNormal, &spareBits, sizeof(spareBits));
+	uniforms.restoreState(is);
+}
+
+double deviationSampler::sampleNormal(const deviationParams &params) {
+	double value = params.mean;
+	for (unsigned int i = 0; i < MAX_REJECTED_SAMPLES; i++) {
+		double z;
+		if (hasSpareNormal) {
+			z = spareNormal;
+			hasSpareNormal = false;
+		} else {
+			double radius = std::sqrt(-2.0 * std::log(uniforms.next()));
+			double angle = 2.0 * M_PI * uniforms.next();
+			z = radius * std::cos(angle);
+			spareNormal = radius * std::sin(angle);
+			hasSpareNormal = true;
+		}
+		value = params.mean + params.sd * z;
+		if (value >= params.lowerBound && value <= params.upperBound) {
+			break;
+		}
+	}
+	return value;
+}
+
+double deviationSampler::sampleWeibull(const deviationParams &params) {
+	double value = params.lambda;
+	for (unsigned int i = 0; i < MAX_REJECTED_SAMPLES; i++) {
+		value = params.lambda
+				* std::pow(-std::log(uniforms.next()), params.invKappa);
+		if (value >= params.lowerBound && value <= params.upperBound) {
+			break;
+		}
+	}
+	return value;
+}
+
+}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  END OF FILE.                                                              //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
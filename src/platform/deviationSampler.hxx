@@ -0,0 +1,115 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//                           DREAMCLOUD PROJECT                               //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DREAMCLOUD__PLATFORM_SCLIB__DEVIATIONSAMPLER_HXX
+#define DREAMCLOUD__PLATFORM_SCLIB__DEVIATIONSAMPLER_HXX
+
+////////////////////
+//    INCLUDES    //
+////////////////////
+#include <stdint.h>
+#include <iostream>
+#include <unordered_map>
+#include "commons/parser/dcApplication.h"
+
+namespace dreamcloud {
+namespace platform_sclib {
+
+////////////////////
+//      USING     //
+////////////////////
+using namespace DCApplication;
+
+// Sampling parameters of an InstructionsDeviation, computed once from
+// the instruction fields. The distribution is a Weibull one when Kappa
+// is set or when RemainPromille is set with Mean and an upper bound, a
+// Gaussian one when SD is set and a uniform one otherwise. Samples are
+// always kept within the instruction bounds.
+typedef struct deviationParams {
+	enum Kind {
+		UNIFORM, NORMAL, WEIBULL
+	} kind;
+	double lowerBound;
+	double upperBound;
+	double mean;
+	double sd;
+	double lambda;
+	double invKappa;
+} deviationParams;
+
+deviationParams computeDeviationParams(
+		dcExecutionCyclesDeviationInstruction *inst);
+
+// Parameters of all the deviation instructions of the application,
+// shared by all the PEs and rebuilt when instructions are updated
+typedef std::unordered_map<dcInstruction *, deviationParams> deviationParamsTable;
+
+/**
+ * Generator of uniform doubles in ]0, 1[ filling a buffer of samples
+ * at once with independent xorshift64* lanes. The lanes loop has no
+ * dependency between iterations so the compiler can vectorize it.
+ */
+class uniformBatchGenerator {
+
+public:
+	uniformBatchGenerator(uint64_t seed);
+
+	inline double next() {
+		if (index == BATCH_SIZE) {
+			refill();
+		}
+		return buffer[index++];
+	}
+
+	// Lanes, buffered samples and position, written as integers so
+	// that a restored generator draws exactly the same samples
+	void saveState(std::ostream &os) const;
+	void restoreState(std::istream &is);
+
+private:
+	static const unsigned int NB_LANES = 4;
+	static const unsigned int BATCH_SIZE = 256;
+
+	void refill();
+
+	uint64_t state[NB_LANES];
+	double buffer[BATCH_SIZE];
+	unsigned int index;
+};
+
+/**
+ * Draw numbers of instructions of deviation instructions.
+ */
+class deviationSampler {
+
+public:
+	deviationSampler(uint64_t seed);
+	unsigned long int sample(const deviationParams &params);
+
+	void saveState(std::ostream &os) const;
+	void restoreState(std::istream &is);
+
+private:
+	double sampleNormal(const deviationParams &params);
+	double sampleWeibull(const deviationParams &params);
+
+	uniformBatchGenerator uniforms;
+
+	// Box-Muller gives two gaussian samples, the second one is kept here
+	double spareNormal;
+	bool hasSpareNormal;
+};
+
+}
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  END OF FILE.                                                              //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
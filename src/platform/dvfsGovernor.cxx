@@ -0,0 +1,76 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//                           DREAMCLOUD PROJECT                               //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////
+//    INCLUDES    //
+////////////////////
+#include "dvfsGovernor.hxx"
+#include <cstddef>
+
+namespace dreamcloud {
+namespace platform_sclib {
+
+dvfsGovernor::~dvfsGovernor() {
+	// Nothing to do
+}
+
+dvfsGovernor *dvfsGovernor::create(string name) {
+	if (name == "fixed") {
+		return new dvfsFixedGovernor();
+	} else if (name == "ondemand") {
+		return new dvfsOnDemandGovernor();
+	} else if (name == "slack") {
+		return new dvfsSlackGovernor();
+	}
+	return NULL;
+}
+
+unsigned int dvfsFixedGovernor::selectOperatingPoint(unsigned int current,
+		const domainActivity &activity, const vector<operatingPoint> &table) {
+	return current;
+}
+
+dvfsOnDemandGovernor::dvfsOnDemandGovernor(double upThreshold_,
+		double downThreshold_) :
+		upThreshold(upThreshold_), downThreshold(downThreshold_) {
+}
+
+unsigned int dvfsOnDemandGovernor::selectOperatingPoint(unsigned int current,
+		const domainActivity &activity, const vector<operatingPoint> &table) {
+	if (activity.utilization > upThreshold) {
+		return table.size() - 1;
+	}
+	if (activity.utilization < downThreshold && current > 0) {
+		return current - 1;
+	}
+	return current;
+}
+
+dvfsSlackGovernor::dvfsSlackGovernor(double lowSlackRatio_,
+		double highSlackRatio_) :
+		lowSlackRatio(lowSlackRatio_), highSlackRatio(highSlackRatio_) {
+}
+
+unsigned int dvfsSlackGovernor::selectOperatingPoint(unsigned int current,
+		const domainActivity &activity, const vector<operatingPoint> &table) {
+	if (activity.nbDeadlinesMissed > 0
+			|| activity.minSlackRatio < lowSlackRatio) {
+		return current + 1 < table.size() ? current + 1 : current;
+	}
+	if (activity.minSlackRatio > highSlackRatio && current > 0) {
+		return current - 1;
+	}
+	return current;
+}
+
+}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  END OF FILE.                                                              //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
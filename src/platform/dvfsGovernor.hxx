@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//                           DREAMCLOUD PROJECT                               //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DREAMCLOUD__PLATFORM_SCLIB__DVFSGOVERNOR_HXX
+#define DREAMCLOUD__PLATFORM_SCLIB__DVFSGOVERNOR_HXX
+
+////////////////////
+//    INCLUDES    //
+////////////////////
+#include <string>
+#include <vector>
+
+namespace dreamcloud {
+namespace platform_sclib {
+
+////////////////////
+//      USING     //
+////////////////////
+using std::string;
+using std::vector;
+
+// One entry of a DVFS operating points table
+typedef struct operatingPoint {
+	unsigned long int frequencyInHz;
+	double voltage;
+} operatingPoint;
+
+// Activity of a clock domain during the last governor period
+typedef struct domainActivity {
+	double utilization; // computation time / (period * nb PEs), between 0 and 1
+	double minSlackRatio; // min of (deadline - duration) / deadline of completed runnables, 1 if none
+	unsigned int nbDeadlinesMissed;
+} domainActivity;
+
+/**
+ * Base class of DVFS governors. Every governor period, the governor
+ * of each clock domain is given the domain activity and the index of
+ * the current operating point (the table is sorted by increasing
+ * frequency) and returns the index of the operating point to use.
+ */
+class dvfsGovernor {
+
+public:
+	virtual ~dvfsGovernor();
+	virtual unsigned int selectOperatingPoint(unsigned int current,
+			const domainActivity &activity,
+			const vector<operatingPoint> &table) = 0;
+
+	// Return the governor with the given name or NULL if unknown
+	static dvfsGovernor *create(string name);
+};
+
+/**
+ * Keep the domain at its initial operating point.
+ */
+class dvfsFixedGovernor: public dvfsGovernor {
+public:
+	unsigned int selectOperatingPoint(unsigned int current,
+			const domainActivity &activity,
+			const vector<operatingPoint> &table);
+};
+
+/**
+ * Jump to the highest frequency when the domain is busy and step
+ * down one operating point at a time when it is mostly idle.
+ */
+class dvfsOnDemandGovernor: public dvfsGovernor {
+public:
+	dvfsOnDemandGovernor(double upThreshold = 0.8, double downThreshold =
+			0.3);
+	unsigned int selectOperatingPoint(unsigned int current,
+			const domainActivity &activity,
+			const vector<operatingPoint> &table);
+private:
+	double upThreshold;
+	double downThreshold;
+};
+
+/**
+ * Step up one operating point when a deadline has been missed or the
+ * slack of the runnables is getting low, step down when all the
+ * runnables completed with a comfortable slack.
+ */
+class dvfsSlackGovernor: public dvfsGovernor {
+public:
+	dvfsSlackGovernor(double lowSlackRatio = 0.1, double highSlackRatio =
+			0.3);
+	unsigned int selectOperatingPoint(unsigned int current,
+			const domainActivity &activity,
+			const vector<operatingPoint> &table);
+private:
+	double lowSlackRatio;
+	double highSlackRatio;
+};
+
+}
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  END OF FILE.                                                              //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,116 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//                           DREAMCLOUD PROJECT                               //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////
+//    INCLUDES    //
+////////////////////
+#include "fidelityController.hxx"
+
+namespace dreamcloud {
+namespace platform_sclib {
+
+////////////////////
+//      USING     //
+////////////////////
+using std::endl;
+
+fidelityController::fidelityController(vector<fidelityWindow> windows_,
+		unsigned long int afterMissInNano_, string outputFolder) :
+		windows(windows_), afterMissInNano(afterMissInNano_), missWindowEndInNano(
+				0), accurate(false), windowStartInNano(0), nbAccurateWindows(
+				0), accurateTimeInNano(0) {
+	csvFile.open(outputFolder + "/OUTPUT_Fidelity_Windows.csv");
+	csvFile << "Start(ns),End(ns),Trigger" << endl;
+}
+
+fidelityController::~fidelityController() {
+	csvFile.close();
+}
+
+unsigned int fidelityController::getEvents() const {
+	return RUNNABLE_COMPLETED;
+}
+
+void fidelityController::runnableCompleted(dcRunnableInstance *runnable,
+		unsigned int x, unsigned int y,
+		unsigned long int executionTimeInPico) {
+	if (afterMissInNano == 0
+			|| executionTimeInPico * 1E-3
+					<= runnable->getRunCall()->GetDeadlineValueInNano()) {
+		return;
+	}
+	unsigned long int endInNano = runnable->GetCompletionTime() / 1E3
+			+ afterMissInNano;
+	if (endInNano > missWindowEndInNano) {
+		missWindowEndInNano = endInNano;
+		deadlineMiss_event.notify(SC_ZERO_TIME);
+	}
+}
+
+bool fidelityController::update(unsigned long int nowInNano) {
+	string trigger;
+	for (vector<fidelityWindow>::const_iterator it = windows.begin();
+			it != windows.end(); ++it) {
+		if (it->startInNano <= nowInNano && nowInNano < it->endInNano) {
+			trigger = it->trigger;
+			break;
+		}
+	}
+	if (trigger.empty() && nowInNano < missWindowEndInNano) {
+		trigger = "deadline miss";
+	}
+	if (!trigger.empty() && !accurate) {
+		windowStartInNano = nowInNano;
+		windowTrigger = trigger;
+		nbAccurateWindows++;
+	} else if (trigger.empty() && accurate) {
+		closeWindow(nowInNano);
+	}
+	accurate = !trigger.empty();
+	return accurate;
+}
+
+unsigned long int fidelityController::getNextChange(
+		unsigned long int nowInNano) const {
+	unsigned long int next = 0;
+	if (missWindowEndInNano > nowInNano) {
+		next = missWindowEndInNano;
+	}
+	for (vector<fidelityWindow>::const_iterator it = windows.begin();
+			it != windows.end(); ++it) {
+		unsigned long int boundary =
+				it->startInNano > nowInNano ? it->startInNano : it->endInNano;
+		if (boundary > nowInNano && (next == 0 || boundary < next)) {
+			next = boundary;
+		}
+	}
+	return next;
+}
+
+void fidelityController::closeWindow(unsigned long int endInNano) {
+	csvFile << windowStartInNano << "," << endInNano << "," << windowTrigger
+			<< endl;
+	accurateTimeInNano += endInNano - windowStartInNano;
+}
+
+void fidelityController::report(ostream &os, unsigned long int endInNano) {
+	if (accurate) {
+		closeWindow(endInNano);
+		accurate = false;
+	}
+	os << "    Cycle-accurate XBAR windows                   : "
+			<< nbAccurateWindows << " (" << accurateTimeInNano << " ns of "
+			<< endInNano << " ns)" << endl;
+}
+
+}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  END OF FILE.                                                              //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//                           DREAMCLOUD PROJECT                               //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DREAMCLOUD__PLATFORM_SCLIB__FIDELITYCONTROLLER_HXX
+#define DREAMCLOUD__PLATFORM_SCLIB__FIDELITYCONTROLLER_HXX
+
+////////////////////
+//    INCLUDES    //
+////////////////////
+#include <iostream>
+#include <vector>
+#include "outputSink.hxx"
+
+namespace dreamcloud {
+namespace platform_sclib {
+
+////////////////////
+//      USING     //
+////////////////////
+using std::ostream;
+using std::vector;
+
+// Time interval during which the XBAR is cycle-accurate
+typedef struct fidelityWindow {
+	unsigned long int startInNano;
+	unsigned long int endInNano; // excluded
+	string trigger; // logged in OUTPUT_Fidelity_Windows.csv
+} fidelityWindow;
+
+/**
+ * Windows of the hybrid fidelity, in which the XBAR is cycle-accurate
+ * while its functional model is used the rest of the time. The static
+ * windows are known before the simulation (-accurateWindows and the
+ * windows around the mode switches), a deadline miss opens a window
+ * of -accurateAfterMiss ns from the completion of the runnable.
+ *
+ * The controller is a sink of the completed runnables to detect the
+ * deadline misses, with the same rule as the PEs count. Each
+ * cycle-accurate window actually simulated is written to
+ * OUTPUT_Fidelity_Windows.csv with what triggered it.
+ */
+class fidelityController: public outputSink {
+
+public:
+	fidelityController(vector<fidelityWindow> windows_,
+			unsigned long int afterMissInNano_, string outputFolder);
+	~fidelityController();
+	unsigned int getEvents() const;
+	void runnableCompleted(dcRunnableInstance *runnable, unsigned int x,
+			unsigned int y, unsigned long int executionTimeInPico);
+
+	// Return whether the XBAR is cycle-accurate at the given time and
+	// log the window when it starts or ends
+	bool update(unsigned long int nowInNano);
+
+	// Time of the next static window boundary or end of a deadline
+	// miss window after the given time, 0 if there is none
+	unsigned long int getNextChange(unsigned long int nowInNano) const;
+
+	// Notified when a deadline miss opens or extends a window
+	inline sc_event& getDeadlineMissEvent() {
+		return deadlineMiss_event;
+	}
+
+	// Close the current window and print the time spent cycle-accurate
+	void report(ostream &os, unsigned long int endInNano);
+
+private:
+	void closeWindow(unsigned long int endInNano);
+
+	vector<fidelityWindow> windows;
+	unsigned long int afterMissInNano;
+	unsigned long int missWindowEndInNano;
+	sc_event deadlineMiss_event;
+	bool accurate;
+	unsigned long int windowStartInNano; // of the current window
+	string windowTrigger;
+	unsigned long int nbAccurateWindows;
+	unsigned long int accurateTimeInNano;
+	ofstream csvFile;
+};
+
+}
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  END OF FILE.                                                              //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,195 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//                           DREAMCLOUD PROJECT                               //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////
+//    INCLUDES    //
+////////////////////
+#include "hyperperiodSampler.hxx"
+#include <algorithm>
+#include <cmath>
+
+namespace dreamcloud {
+namespace platform_sclib {
+
+////////////////////
+//      USING     //
+////////////////////
+using std::endl;
+
+// Two-sided 95 % quantiles of the Student distribution for 1 to 30
+// degrees of freedom
+static const double STUDENT_95_QUANTILES[] = { 12.706, 4.303, 3.182, 2.776,
+		2.571, 2.447, 2.365, 2.306, 2.262, 2.228, 2.201, 2.179, 2.160, 2.145,
+		2.131, 2.120, 2.110, 2.101, 2.093, 2.086, 2.080, 2.074, 2.069, 2.064,
+		2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+
+static double getStudentQuantile(unsigned long int degreesOfFreedom) {
+	if (degreesOfFreedom <= 30) {
+		return STUDENT_95_QUANTILES[degreesOfFreedom - 1];
+	} else if (degreesOfFreedom <= 40) {
+		return 2.021;
+	} else if (degreesOfFreedom <= 60) {
+		return 2.000;
+	} else if (degreesOfFreedom <= 120) {
+		return 1.980;
+	}
+	return 1.960;
+}
+
+hyperperiodSampler::hyperperiodSampler(unsigned long int nbHyperperiods_,
+		unsigned long int nbSamples, unsigned long int hyperPeriodInNano_,
+		unsigned int rows, unsigned int cols_) :
+		nbHyperperiods(nbHyperperiods_), hyperPeriodInNano(hyperPeriodInNano_), cols(
+				cols_), current(0), nbFastForwardedRunnables(0) {
+	// Evenly spread samples starting at the first hyperperiod
+	for (unsigned long int s = 0; s < nbSamples; s++) {
+		hyperperiodSample sample = hyperperiodSample();
+		sample.hyperperiod = s * nbHyperperiods / nbSamples;
+		samples.push_back(sample);
+	}
+	runnables.resize(rows * cols);
+	previousRunnables.resize(rows * cols);
+}
+
+unsigned int hyperperiodSampler::getEvents() const {
+	return RUNNABLE_COMPLETED;
+}
+
+void hyperperiodSampler::runnableCompleted(dcRunnableInstance *runnable,
+		unsigned int x, unsigned int y,
+		unsigned long int executionTimeInPico) {
+	hyperperiodSample &sample = samples[current];
+	dcRunnableCall *run = runnable->getRunCall();
+	double responseTimeInNano = (runnable->GetCompletionTime()
+			- runnable->GetReleaseTime()) / 1E3;
+	sample.nbRunnables++;
+	sample.sumResponseTimeInNano += responseTimeInNano;
+	sample.maxResponseTimeInNano = std::max(sample.maxResponseTimeInNano,
+			responseTimeInNano);
+
+	// Same rule as the PEs deadline misses count
+	if (executionTimeInPico * 1E-3 > run->GetDeadlineValueInNano()) {
+		sample.nbDeadlineMisses++;
+	}
+	runnables[x * cols + y].push_back(run);
+}
+
+unsigned long int hyperperiodSampler::startSample(unsigned long int sample) {
+	unsigned long int nbSkipped = samples[sample].hyperperiod
+			- samples[sample - 1].hyperperiod - 1;
+	previousRunnables.swap(runnables);
+	for (vector<vector<dcRunnableCall *> >::iterator it = runnables.begin();
+			it != runnables.end(); ++it) {
+		nbFastForwardedRunnables += nbSkipped * previousRunnables[it
+				- runnables.begin()].size();
+		it->clear();
+	}
+	current = sample;
+	return nbSkipped;
+}
+
+const vector<dcRunnableCall *>& hyperperiodSampler::getPreviousRunnables(
+		unsigned int pe) const {
+	return previousRunnables[pe];
+}
+
+/**
+ * Mean of the values of the samples with the half width of its 95 %
+ * confidence interval, corrected for the share of the covered
+ * hyperperiods that was sampled.
+ */
+sampledEstimate hyperperiodSampler::estimate(
+		const vector<double> &values) const {
+	sampledEstimate result = { 0, 0 };
+	unsigned long int n = values.size();
+	for (vector<double>::const_iterator it = values.begin();
+			it != values.end(); ++it) {
+		result.mean += *it;
+	}
+	result.mean /= n;
+	if (n < 2) {
+		return result;
+	}
+	double sumSquares = 0;
+	for (vector<double>::const_iterator it = values.begin();
+			it != values.end(); ++it) {
+		sumSquares += (*it - result.mean) * (*it - result.mean);
+	}
+	double standardError = std::sqrt(sumSquares / (n - 1) / n);
+	double finitePopulation = std::sqrt(1.0 - (double) n / nbHyperperiods);
+	result.halfWidth = getStudentQuantile(n - 1) * standardError
+			* finitePopulation;
+	return result;
+}
+
+void hyperperiodSampler::report(ostream &os, string outputFolder) const {
+	ofstream f(outputFolder + "/OUTPUT_Hyperperiod_Samples.csv");
+	f << "Hyperperiod,Start time(ns),Runnables,Deadline misses,"
+			"Deadline miss rate,Average response time(ns),"
+			"Max response time(ns)" << endl;
+	vector<double> nbRunnables;
+	vector<double> nbMisses;
+	vector<double> missRates;
+	vector<double> averageResponseTimes;
+	vector<double> maxResponseTimes;
+	for (vector<hyperperiodSample>::const_iterator it = samples.begin();
+			it != samples.end(); ++it) {
+		double missRate =
+				it->nbRunnables > 0 ?
+						(double) it->nbDeadlineMisses / it->nbRunnables : 0;
+		double averageResponseTime =
+				it->nbRunnables > 0 ?
+						it->sumResponseTimeInNano / it->nbRunnables : 0;
+		f << it->hyperperiod << "," << it->hyperperiod * hyperPeriodInNano
+				<< "," << it->nbRunnables << "," << it->nbDeadlineMisses << ","
+				<< missRate << "," << averageResponseTime << ","
+				<< it->maxResponseTimeInNano << endl;
+		nbRunnables.push_back(it->nbRunnables);
+		nbMisses.push_back(it->nbDeadlineMisses);
+		missRates.push_back(missRate);
+		averageResponseTimes.push_back(averageResponseTime);
+		maxResponseTimes.push_back(it->maxResponseTimeInNano);
+	}
+	f.close();
+
+	sampledEstimate runnablesEstimate = estimate(nbRunnables);
+	sampledEstimate missesEstimate = estimate(nbMisses);
+	sampledEstimate missRateEstimate = estimate(missRates);
+	sampledEstimate responseEstimate = estimate(averageResponseTimes);
+	sampledEstimate worstEstimate = estimate(maxResponseTimes);
+	os << " ##Hyperperiod sampling##" << endl << endl;
+	os << "    Hyperperiods covered / simulated in detail    : "
+			<< nbHyperperiods << " / " << samples.size() << endl;
+	os << "    Covered operation time                        : "
+			<< nbHyperperiods * hyperPeriodInNano << " ns" << endl;
+	os << "    Runnable instances fast-forwarded             : "
+			<< nbFastForwardedRunnables << endl;
+	os << "    Deadline miss rate (95 % confidence)          : "
+			<< missRateEstimate.mean << " +/- " << missRateEstimate.halfWidth
+			<< endl;
+	os << "    Average response time (95 % confidence)       : "
+			<< responseEstimate.mean << " +/- " << responseEstimate.halfWidth
+			<< " ns" << endl;
+	os << "    Worst response time per hyperperiod (95 %)    : "
+			<< worstEstimate.mean << " +/- " << worstEstimate.halfWidth
+			<< " ns" << endl;
+	os << "    Estimated runnable instances over covered time: "
+			<< runnablesEstimate.mean * nbHyperperiods << " +/- "
+			<< runnablesEstimate.halfWidth * nbHyperperiods << endl;
+	os << "    Estimated deadline misses over covered time   : "
+			<< missesEstimate.mean * nbHyperperiods << " +/- "
+			<< missesEstimate.halfWidth * nbHyperperiods << endl;
+	os << endl;
+}
+
+}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  END OF FILE.                                                              //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
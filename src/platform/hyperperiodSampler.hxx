@@ -0,0 +1,105 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//                           DREAMCLOUD PROJECT                               //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DREAMCLOUD__PLATFORM_SCLIB__HYPERPERIODSAMPLER_HXX
+#define DREAMCLOUD__PLATFORM_SCLIB__HYPERPERIODSAMPLER_HXX
+
+////////////////////
+//    INCLUDES    //
+////////////////////
+#include <iostream>
+#include <vector>
+#include "outputSink.hxx"
+
+namespace dreamcloud {
+namespace platform_sclib {
+
+////////////////////
+//      USING     //
+////////////////////
+using std::ostream;
+using std::vector;
+
+// Runnables completed during one hyperperiod simulated in detail
+typedef struct hyperperiodSample {
+	unsigned long int hyperperiod; // index among the covered hyperperiods
+	unsigned long int nbRunnables;
+	unsigned long int nbDeadlineMisses;
+	double sumResponseTimeInNano;
+	double maxResponseTimeInNano;
+} hyperperiodSample;
+
+// Estimate of the mean of a metric over the covered hyperperiods
+// with the half width of its 95 % confidence interval
+typedef struct sampledEstimate {
+	double mean;
+	double halfWidth; // 0 with a single sample or when all are sampled
+} sampledEstimate;
+
+/**
+ * Statistical sampling of a long periodic run. Out of -hyperperiods
+ * covered hyperperiods, -samples evenly spread ones are simulated in
+ * detail, back to back, so that each one starts with the state left by
+ * the previous one. The hyperperiods in between are executed by the
+ * functional model of the PEs (see processingElement::fastForward),
+ * which replays the runnables of the previous sample without timing so
+ * that the deviation samplers and instruction counters end up where a
+ * full run would leave them.
+ *
+ * Completed runnables are attributed to the sample during which they
+ * complete. The deadline miss rate, average and worst response time
+ * (completion minus release) of each sample are then extrapolated to
+ * the covered hyperperiods with Student confidence intervals.
+ */
+class hyperperiodSampler: public outputSink {
+
+public:
+	hyperperiodSampler(unsigned long int nbHyperperiods_,
+			unsigned long int nbSamples, unsigned long int hyperPeriodInNano_,
+			unsigned int rows, unsigned int cols);
+	unsigned int getEvents() const;
+	void runnableCompleted(dcRunnableInstance *runnable, unsigned int x,
+			unsigned int y, unsigned long int executionTimeInPico);
+
+	inline unsigned long int getNbSamples() const {
+		return samples.size();
+	}
+
+	// Start the given sample, return the number of hyperperiods to
+	// fast-forward before it
+	unsigned long int startSample(unsigned long int sample);
+
+	// Runnables completed by the PE (row major index) during the
+	// previous sample, replayed by the functional model
+	const vector<dcRunnableCall *>& getPreviousRunnables(
+			unsigned int pe) const;
+
+	// Print the estimates and write OUTPUT_Hyperperiod_Samples.csv
+	void report(ostream &os, string outputFolder) const;
+
+private:
+	sampledEstimate estimate(const vector<double> &values) const;
+
+	unsigned long int nbHyperperiods;
+	unsigned long int hyperPeriodInNano;
+	unsigned int cols;
+	vector<hyperperiodSample> samples;
+	unsigned long int current;
+	unsigned long int nbFastForwardedRunnables;
+	vector<vector<dcRunnableCall *> > runnables; // per PE, current sample
+	vector<vector<dcRunnableCall *> > previousRunnables;
+};
+
+}
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  END OF FILE.                                                              //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
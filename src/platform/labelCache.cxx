@@ -0,0 +1,129 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//                           DREAMCLOUD PROJECT                               //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////
+//    INCLUDES    //
+////////////////////
+#include "labelCache.hxx"
+#include "dcConfiguration.hxx"
+#include <algorithm>
+
+namespace dreamcloud {
+namespace platform_sclib {
+
+labelCache::labelCache(unsigned long int capacityInBytes,
+		unsigned int associativity_) :
+		associativity(associativity_), useCounter(0) {
+	if (associativity == 0) {
+		associativity = 1;
+	}
+	unsigned long int nbSets = capacityInBytes
+			/ (associativity * PACKET_SIZE_IN_BYTES);
+	if (nbSets == 0) {
+		nbSets = 1;
+	}
+	setCapacityInBytes = capacityInBytes / nbSets;
+	sets.resize(nbSets);
+}
+
+vector<labelCache::cacheEntry>& labelCache::getSet(int labelId) {
+	return sets[labelId % sets.size()];
+}
+
+const vector<labelCache::cacheEntry>& labelCache::getSet(int labelId) const {
+	return sets[labelId % sets.size()];
+}
+
+bool labelCache::lookup(int labelId) {
+	vector<cacheEntry>& set = getSet(labelId);
+	for (vector<cacheEntry>::iterator it = set.begin(); it != set.end(); ++it) {
+		if (it->labelId == labelId) {
+			it->lastUse = ++useCounter;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool labelCache::contains(int labelId) const {
+	const vector<cacheEntry>& set = getSet(labelId);
+	for (vector<cacheEntry>::const_iterator it = set.begin(); it != set.end();
+			++it) {
+		if (it->labelId == labelId) {
+			return true;
+		}
+	}
+	return false;
+}
+
+vector<int> labelCache::fill(int labelId, unsigned long int sizeInBytes) {
+	vector<int> evicted;
+	if (sizeInBytes > setCapacityInBytes || lookup(labelId)) {
+		return evicted;
+	}
+	vector<cacheEntry>& set = getSet(labelId);
+	unsigned long int usedBytes = 0;
+	for (vector<cacheEntry>::iterator it = set.begin(); it != set.end(); ++it) {
+		usedBytes += it->sizeInBytes;
+	}
+	while (set.size() >= associativity
+			|| usedBytes + sizeInBytes > setCapacityInBytes) {
+		vector<cacheEntry>::iterator lru = std::min_element(set.begin(),
+				set.end(), [](const cacheEntry &left, const cacheEntry &right)
+				{
+					return left.lastUse < right.lastUse;
+				});
+		usedBytes -= lru->sizeInBytes;
+		evicted.push_back(lru->labelId);
+		set.erase(lru);
+	}
+	cacheEntry entry = { labelId, sizeInBytes, ++useCounter };
+	set.push_back(entry);
+	return evicted;
+}
+
+bool labelCache::invalidate(int labelId) {
+	vector<cacheEntry>& set = getSet(labelId);
+	for (vector<cacheEntry>::iterator it = set.begin(); it != set.end(); ++it) {
+		if (it->labelId == labelId) {
+			set.erase(it);
+			return true;
+		}
+	}
+	return false;
+}
+
+unsigned int labelCache::getNbSets() const {
+	return sets.size();
+}
+
+vector<pair<int, unsigned long int> > labelCache::getLabels() const {
+	vector<cacheEntry> entries;
+	for (vector<vector<cacheEntry> >::const_iterator set = sets.begin();
+			set != sets.end(); ++set) {
+		entries.insert(entries.end(), set->begin(), set->end());
+	}
+	std::sort(entries.begin(), entries.end(),
+			[](const cacheEntry &left, const cacheEntry &right)
+			{
+				return left.lastUse < right.lastUse;
+			});
+	vector<pair<int, unsigned long int> > labels;
+	for (vector<cacheEntry>::iterator it = entries.begin(); it != entries.end();
+			++it) {
+		labels.push_back(std::make_pair(it->labelId, it->sizeInBytes));
+	}
+	return labels;
+}
+
+}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  END OF FILE.                                                              //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
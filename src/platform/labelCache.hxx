@@ -0,0 +1,87 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//                           DREAMCLOUD PROJECT                               //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DREAMCLOUD__PLATFORM_SCLIB__LABELCACHE_HXX
+#define DREAMCLOUD__PLATFORM_SCLIB__LABELCACHE_HXX
+
+////////////////////
+//    INCLUDES    //
+////////////////////
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace dreamcloud {
+namespace platform_sclib {
+
+////////////////////
+//      USING     //
+////////////////////
+using std::map;
+using std::pair;
+using std::vector;
+
+// Directory of the PEs holding a copy of each label (indexed by label ID).
+// It is shared by all the PEs and updated when caches are filled or lose
+// a label, writers use it to know where to send coherence packets.
+typedef map<int, vector<pair<int, int> > > labelSharersTable;
+
+/**
+ * Set associative cache of remote labels held in the local memory
+ * of a PE. Labels are mapped to sets by ID and each set holds at most
+ * associativity labels within a budget of capacity / nbSets bytes.
+ * The least recently used labels of a set are evicted first.
+ */
+class labelCache {
+
+public:
+	labelCache(unsigned long int capacityInBytes, unsigned int associativity);
+
+	// Return true and update LRU state if the label is cached
+	bool lookup(int labelId);
+
+	// Return true if the label is cached, without touching LRU state
+	bool contains(int labelId) const;
+
+	// Insert the label and return the IDs of the evicted ones.
+	// Labels bigger than a set are not cached.
+	vector<int> fill(int labelId, unsigned long int sizeInBytes);
+
+	// Remove the label, return true if it was cached
+	bool invalidate(int labelId);
+
+	unsigned int getNbSets() const;
+
+	// Return the (ID, size) of the cached labels, least recently used
+	// first, so that filling them in this order gives the same cache
+	vector<pair<int, unsigned long int> > getLabels() const;
+
+private:
+	typedef struct cacheEntry {
+		int labelId;
+		unsigned long int sizeInBytes;
+		unsigned long int lastUse;
+	} cacheEntry;
+
+	vector<cacheEntry>& getSet(int labelId);
+	const vector<cacheEntry>& getSet(int labelId) const;
+
+	unsigned int associativity;
+	unsigned long int setCapacityInBytes;
+	vector<vector<cacheEntry> > sets;
+	unsigned long int useCounter;
+};
+
+}
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  END OF FILE.                                                              //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
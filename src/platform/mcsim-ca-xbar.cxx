@@ -9,6 +9,9 @@
 ////////////////////
 #include "dcSystem.hxx"
 #include "dcSimuParams.hxx"
+#include "parameterSweep.hxx"
+#include "replaySystem.hxx"
+#include "trafficSystem.hxx"
 
 ////////////////////
 //      USING     //
@@ -20,6 +23,12 @@ using namespace std;
 
 int sc_main(int argc, char** argv) {
 
+	// Run a parameter sweep when several values are given
+	parameterSweep sweep(argc, argv);
+	if (sweep.getNbConfigurations() > 1) {
+		return sweep.run();
+	}
+
 	// Parse arguments
 	dcSimuParams params(argc, argv);
 	if (params.getHelp()) {
@@ -31,6 +40,23 @@ int sc_main(int argc, char** argv) {
 	sc_core::sc_report_handler::set_actions("/IEEE_Std_1666/deprecated",
 			sc_core::SC_DO_NOTHING);
 	sc_clock clock("my_clock", params.getCoresPeriodInNano(), SC_NS, 0.5);
+
+	// Synthetic traffic characterization of the crossbar
+	if (!params.getTrafficPattern().empty()) {
+		trafficSystem system("trafficSystem", params);
+		system.clock(clock);
+		sc_start();
+		return 0;
+	}
+
+	// Replay of a packet trace through the crossbar alone
+	if (!params.getReplayFile().empty()) {
+		replaySystem system("replaySystem", params);
+		system.clock(clock);
+		sc_start();
+		return 0;
+	}
+
 	dcSystem system("dcSsytem", params);
 	system.clock(clock);
 
@@ -0,0 +1,223 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//                           DREAMCLOUD PROJECT                               //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////
+//    INCLUDES    //
+////////////////////
+#include "outputSink.hxx"
+#include <iomanip>
+#include <cstddef>
+
+namespace dreamcloud {
+namespace platform_sclib {
+
+////////////////////
+//      USING     //
+////////////////////
+using std::endl;
+using std::fixed;
+using std::setprecision;
+
+outputSink::~outputSink() {
+	// Nothing to do
+}
+
+void outputSink::runnableMapped(dcRunnableInstance *runnable, unsigned int x,
+		unsigned int y) {
+	// Nothing to do
+}
+
+void outputSink::runnableCompleted(dcRunnableInstance *runnable,
+		unsigned int x, unsigned int y,
+		unsigned long int executionTimeInPico) {
+	// Nothing to do
+}
+
+void outputSink::packetReceived(const Packet &p) {
+	// Nothing to do
+}
+
+outputSink *outputSink::create(string name, string outputFolder) {
+	if (name == "mapping") {
+		return new mappingCsvSink(outputFolder + "/Mapping.csv");
+	} else if (name == "runnables_csv") {
+		return new runnablesCsvSink(
+				outputFolder + "/OUTPUT_Runnable_Traces.csv");
+	} else if (name == "runnables_arff") {
+		return new runnablesArffSink(
+				outputFolder + "/OUTPUT_Runnable_Traces.arff");
+	} else if (name == "noc_csv") {
+		return new nocTrafficCsvSink(outputFolder + "/OUTPUT_NoC_Traces.csv");
+	} else if (name == "noc_arff") {
+		return new nocTrafficArffSink(
+				outputFolder + "/OUTPUT_NoC_Traces.arff");
+	} else if (name == "packet_trace") {
+		return new packetTraceCsvSink(
+				outputFolder + "/OUTPUT_Packet_Trace.csv");
+	}
+	return NULL;
+}
+
+outputSinks::~outputSinks() {
+	for (vector<outputSink *>::iterator it = sinks.begin(); it != sinks.end();
+			++it) {
+		delete *it;
+	}
+}
+
+void outputSinks::add(outputSink *sink) {
+	sinks.push_back(sink);
+	if (sink->getEvents() & outputSink::RUNNABLE_MAPPED) {
+		mappedSinks.push_back(sink);
+	}
+	if (sink->getEvents() & outputSink::RUNNABLE_COMPLETED) {
+		completedSinks.push_back(sink);
+	}
+	if (sink->getEvents() & outputSink::PACKET_RECEIVED) {
+		packetSinks.push_back(sink);
+	}
+}
+
+mappingCsvSink::mappingCsvSink(string file) :
+		f(file) {
+}
+
+unsigned int mappingCsvSink::getEvents() const {
+	return RUNNABLE_MAPPED;
+}
+
+void mappingCsvSink::runnableMapped(dcRunnableInstance *runnable,
+		unsigned int x, unsigned int y) {
+	f << runnable->getRunCall()->GetRunClassId() << ","
+			<< runnable->getRunCall()->GetRunClassName() << "," << x << y
+			<< endl;
+}
+
+runnablesCsvSink::runnablesCsvSink(string file) :
+		f(file) {
+	f << fixed << setprecision(0);
+	f
+			<< "Core_ID,Runnable,Priority,Allocation_Time,Start_Time,Completion_Time,Duration,Deadline,Deadline_Met_Missed"
+			<< endl;
+}
+
+unsigned int runnablesCsvSink::getEvents() const {
+	return RUNNABLE_COMPLETED;
+}
+
+void runnablesCsvSink::runnableCompleted(dcRunnableInstance *runnable,
+		unsigned int x, unsigned int y,
+		unsigned long int executionTimeInPico) {
+	dcRunnableCall *run = runnable->getRunCall();
+	f << "PE" << x << y << ",";
+	f << run->GetRunClassName() << ",";
+	f << run->GetPriority() << ",";
+	f << (runnable->GetMappingTime() / 1E3) << ",";
+	f << (runnable->GetStartTime() / 1E3) << ",";
+	f << (runnable->GetCompletionTime() / 1E3) << ",";
+	f << (executionTimeInPico / 1E3) << ",";
+	f << (run->GetDeadlineValueInNano()) << ",";
+	f << (run->GetDeadlineValueInNano() - (executionTimeInPico / 1E3))
+			<< endl;
+}
+
+runnablesArffSink::runnablesArffSink(string file) :
+		f(file) {
+	f << "@RELATION runnable" << endl << endl;
+	f << "@ATTRIBUTE coreid           string" << endl;
+	f << "@ATTRIBUTE id               string" << endl;
+	f << "@ATTRIBUTE priority         NUMERIC" << endl;
+	f << "@ATTRIBUTE alloctime        NUMERIC" << endl;
+	f << "@ATTRIBUTE starttime        NUMERIC" << endl;
+	f << "@ATTRIBUTE completiontime   NUMERIC" << endl;
+	f << "@ATTRIBUTE duration         NUMERIC" << endl;
+	f << "@ATTRIBUTE deadline         NUMERIC" << endl;
+	f << "@ATTRIBUTE dealinemetmissed NUMERIC" << endl;
+	f << endl << endl << "@DATA" << endl;
+}
+
+unsigned int runnablesArffSink::getEvents() const {
+	return RUNNABLE_COMPLETED;
+}
+
+void runnablesArffSink::runnableCompleted(dcRunnableInstance *runnable,
+		unsigned int x, unsigned int y,
+		unsigned long int executionTimeInPico) {
+	dcRunnableCall *run = runnable->getRunCall();
+	f << "PE" << x << y << ",";
+	f << fixed << run->GetRunClassName() << ",";
+	f << fixed << run->GetPriority() << ",";
+	f << fixed << (runnable->GetMappingTime() / 1E3) << ",";
+	f << fixed << (runnable->GetStartTime() / 1E3) << ",";
+	f << fixed << (runnable->GetCompletionTime() / 1E3) << ",";
+	f << fixed << (executionTimeInPico / 1E3) << ",";
+	f << fixed << (run->GetDeadlineValueInNano() / 1E3) << ",";
+	f << fixed << (run->GetDeadlineValueInNano() - (executionTimeInPico / 1E3))
+			<< endl;
+}
+
+nocTrafficCsvSink::nocTrafficCsvSink(string file) :
+		f(file) {
+	f
+			<< "Packet ID,Priority,Read Request ID,Source,Destination,Injection Time(NS),Delivery Time(NS),Packet Latency(NS),Latency no Contention(NS)\n";
+}
+
+unsigned int nocTrafficCsvSink::getEvents() const {
+	return PACKET_RECEIVED;
+}
+
+void nocTrafficCsvSink::packetReceived(const Packet &p) {
+	f << p;
+}
+
+packetTraceCsvSink::packetTraceCsvSink(string file) :
+		f(file) {
+	f << "Packet ID,Kind,Priority,Read Request ID,Source Row,Source Col,"
+			"Destination Row,Destination Col,Injection Time(NS),"
+			"Delivery Time(NS)\n";
+}
+
+unsigned int packetTraceCsvSink::getEvents() const {
+	return PACKET_RECEIVED;
+}
+
+void packetTraceCsvSink::packetReceived(const Packet &p) {
+	f << p.get_id() << ","
+			<< (p.isWrite() ? "write" : p.isReadResponse() ? "response" : "read")
+			<< "," << p.get_priority() << "," << p.get_read_request_id() << ","
+			<< p.get_source().first << "," << p.get_source().second << ","
+			<< p.get_destination().first << "," << p.get_destination().second
+			<< "," << p.get_injection_time() << "," << p.get_delivery_time()
+			<< "\n";
+}
+
+nocTrafficArffSink::nocTrafficArffSink(string file) :
+		f(file) {
+	f << "@RELATION packet" << endl << endl;
+	f << "@ATTRIBUTE id            NUMERIC" << endl;
+	f << "@ATTRIBUTE priority      NUMERIC" << endl;
+	f << "@ATTRIBUTE info          NUMERIC" << endl;
+	f << "@ATTRIBUTE source        string" << endl;
+	f << "@ATTRIBUTE destination   string" << endl;
+	f << "@ATTRIBUTE injectiontime NUMERIC" << endl;
+	f << "@ATTRIBUTE deliverytime  NUMERIC" << endl;
+	f << "@ATTRIBUTE latency       NUMERIC" << endl;
+	f << "@ATTRIBUTE hoplatency    NUMERIC" << endl;
+	f << endl << endl << "@DATA" << endl;
+}
+
+unsigned int nocTrafficArffSink::getEvents() const {
+	return 0;
+}
+
+}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  END OF FILE.                                                              //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
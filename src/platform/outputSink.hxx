@@ -0,0 +1,191 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//                           DREAMCLOUD PROJECT                               //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DREAMCLOUD__PLATFORM_SCLIB__OUTPUTSINK_HXX
+#define DREAMCLOUD__PLATFORM_SCLIB__OUTPUTSINK_HXX
+
+////////////////////
+//    INCLUDES    //
+////////////////////
+#include <string>
+#include <vector>
+#include <fstream>
+#include "xbar/packet.hxx"
+#include "commons/parser/dcRunnableInstance.h"
+
+namespace dreamcloud {
+namespace platform_sclib {
+
+////////////////////
+//      USING     //
+////////////////////
+using std::string;
+using std::vector;
+using std::ofstream;
+using dreamcloud::platform_sclib::noc_ppa::Packet;
+using namespace DCApplication;
+
+/**
+ * Base class of the output streams written during the simulation.
+ * A sink only overrides the events it writes and returns them in
+ * getEvents(), it is never called for the other ones.
+ */
+class outputSink {
+
+public:
+	enum Event {
+		RUNNABLE_MAPPED = 1, RUNNABLE_COMPLETED = 2, PACKET_RECEIVED = 4
+	};
+
+	virtual ~outputSink();
+	virtual unsigned int getEvents() const = 0;
+
+	// Runnable sent to PE (x, y) by the mapper
+	virtual void runnableMapped(dcRunnableInstance *runnable, unsigned int x,
+			unsigned int y);
+
+	// Runnable completed by PE (x, y), execution time in ps
+	virtual void runnableCompleted(dcRunnableInstance *runnable,
+			unsigned int x, unsigned int y,
+			unsigned long int executionTimeInPico);
+
+	// Packet received by its destination PE
+	virtual void packetReceived(const Packet &p);
+
+	// Return the sink of the given output written in the given folder,
+	// NULL if the output is not a stream (e.g. the graphs)
+	static outputSink *create(string name, string outputFolder);
+};
+
+/**
+ * Registry of the enabled output sinks. Sinks are kept in one list per
+ * event so that the simulation only checks an empty list for the
+ * events no enabled sink writes.
+ */
+class outputSinks {
+
+public:
+	~outputSinks();
+
+	// Take ownership of the given sink
+	void add(outputSink *sink);
+
+	inline void runnableMapped(dcRunnableInstance *runnable, unsigned int x,
+			unsigned int y) {
+		for (vector<outputSink *>::iterator it = mappedSinks.begin();
+				it != mappedSinks.end(); ++it) {
+			(*it)->runnableMapped(runnable, x, y);
+		}
+	}
+
+	inline void runnableCompleted(dcRunnableInstance *runnable,
+			unsigned int x, unsigned int y,
+			unsigned long int executionTimeInPico) {
+		for (vector<outputSink *>::iterator it = completedSinks.begin();
+				it != completedSinks.end(); ++it) {
+			(*it)->runnableCompleted(runnable, x, y, executionTimeInPico);
+		}
+	}
+
+	inline void packetReceived(const Packet &p) {
+		for (vector<outputSink *>::iterator it = packetSinks.begin();
+				it != packetSinks.end(); ++it) {
+			(*it)->packetReceived(p);
+		}
+	}
+
+private:
+	vector<outputSink *> sinks;
+	vector<outputSink *> mappedSinks;
+	vector<outputSink *> completedSinks;
+	vector<outputSink *> packetSinks;
+};
+
+/**
+ * Mapping.csv: runnable id, name and PE of each mapped runnable.
+ */
+class mappingCsvSink: public outputSink {
+public:
+	mappingCsvSink(string file);
+	unsigned int getEvents() const;
+	void runnableMapped(dcRunnableInstance *runnable, unsigned int x,
+			unsigned int y);
+private:
+	ofstream f;
+};
+
+/**
+ * OUTPUT_Runnable_Traces.csv: one row per completed runnable.
+ */
+class runnablesCsvSink: public outputSink {
+public:
+	runnablesCsvSink(string file);
+	unsigned int getEvents() const;
+	void runnableCompleted(dcRunnableInstance *runnable, unsigned int x,
+			unsigned int y, unsigned long int executionTimeInPico);
+private:
+	ofstream f;
+};
+
+/**
+ * OUTPUT_Runnable_Traces.arff: same rows as the CSV in ARFF format.
+ */
+class runnablesArffSink: public outputSink {
+public:
+	runnablesArffSink(string file);
+	unsigned int getEvents() const;
+	void runnableCompleted(dcRunnableInstance *runnable, unsigned int x,
+			unsigned int y, unsigned long int executionTimeInPico);
+private:
+	ofstream f;
+};
+
+/**
+ * OUTPUT_NoC_Traces.csv: one row per received packet.
+ */
+class nocTrafficCsvSink: public outputSink {
+public:
+	nocTrafficCsvSink(string file);
+	unsigned int getEvents() const;
+	void packetReceived(const Packet &p);
+private:
+	ofstream f;
+};
+
+/**
+ * OUTPUT_Packet_Trace.csv: one row per received packet with what is
+ * needed to replay it through the XBAR alone (see replaySystem).
+ */
+class packetTraceCsvSink: public outputSink {
+public:
+	packetTraceCsvSink(string file);
+	unsigned int getEvents() const;
+	void packetReceived(const Packet &p);
+private:
+	ofstream f;
+};
+
+/**
+ * OUTPUT_NoC_Traces.arff: ARFF header of the packets relation.
+ */
+class nocTrafficArffSink: public outputSink {
+public:
+	nocTrafficArffSink(string file);
+	unsigned int getEvents() const;
+private:
+	ofstream f;
+};
+
+}
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  END OF FILE.                                                              //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
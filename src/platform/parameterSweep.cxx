@@ -0,0 +1,328 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//                           DREAMCLOUD PROJECT                               //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////
+//    INCLUDES    //
+////////////////////
+#include "parameterSweep.hxx"
+#include "trafficSystem.hxx"
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+namespace dreamcloud {
+namespace platform_sclib {
+
+// Options accepting comma separated values
+const char *SWEPT_OPTIONS[] = { "-policy", "-bsize", "-lrc", "-rrc", "-lwc",
+		"-rwc", "-m", "-freq" };
+
+parameterSweep::parameterSweep(int argc, char **argv) {
+	vector<string> args(argv, argv + argc);
+	nbJobs = sysconf(_SC_NPROCESSORS_ONLN);
+	traffic = false;
+	replay = false;
+	configurations.push_back(args);
+	configurationValues.push_back(vector<string>());
+	for (int i = 1; i + 1 < argc; i++) {
+		if (args[i] == "-o") {
+			outputFolder = args[i + 1];
+		} else if (args[i] == "-jobs") {
+			nbJobs = std::stoi(args[i + 1]);
+		}
+		bool swept = false;
+		for (unsigned int o = 0; o < sizeof(SWEPT_OPTIONS) / sizeof(char *);
+				o++) {
+			swept = swept || args[i] == SWEPT_OPTIONS[o];
+		}
+		if (!swept || args[i + 1].find(',') == string::npos) {
+			continue;
+		}
+
+		// Combine each value with all the configurations so far
+		vector<string> values;
+		istringstream is(args[i + 1]);
+		string value;
+		while (getline(is, value, ',')) {
+			values.push_back(value);
+		}
+		vector<vector<string> > combined;
+		vector<vector<string> > combinedValues;
+		for (unsigned int c = 0; c < configurations.size(); c++) {
+			for (vector<string>::iterator it = values.begin();
+					it != values.end(); ++it) {
+				combined.push_back(configurations[c]);
+				combined.back()[i + 1] = *it;
+				combinedValues.push_back(configurationValues[c]);
+				combinedValues.back().push_back(*it);
+			}
+		}
+		configurations = combined;
+		configurationValues = combinedValues;
+		sweptOptions.push_back(args[i].substr(1));
+	}
+	if (nbJobs == 0) {
+		nbJobs = 1;
+	}
+
+	// Each configuration writes its outputs in its own subfolder, the
+	// missing -o is reported when checking the configurations
+	if (outputFolder.empty()) {
+		outputFolder = ".";
+	}
+	for (unsigned int c = 0; c < configurations.size(); c++) {
+		folders.push_back(outputFolder + "/sweep_" + std::to_string(c));
+		for (unsigned int i = 1; i + 1 < configurations[c].size(); i++) {
+			if (configurations[c][i] == "-o") {
+				configurations[c][i + 1] = folders.back();
+			}
+		}
+	}
+}
+
+unsigned int parameterSweep::getNbConfigurations() const {
+	return configurations.size();
+}
+
+vector<char *> parameterSweep::getArgv(unsigned int configuration) {
+	vector<char *> argv;
+	for (vector<string>::iterator it = configurations[configuration].begin();
+			it != configurations[configuration].end(); ++it) {
+		argv.push_back(&(*it)[0]);
+	}
+	argv.push_back(NULL);
+	return argv;
+}
+
+int parameterSweep::run() {
+
+	// Check all the configurations before simulating any of them, with
+	// the sweep output folder since their own folders don't exist yet
+	for (unsigned int c = 0; c < configurations.size(); c++) {
+		vector<string> checked = configurations[c];
+		for (unsigned int i = 1; i + 1 < checked.size(); i++) {
+			if (checked[i] == "-o") {
+				checked[i + 1] = outputFolder;
+			}
+		}
+		vector<char *> argv;
+		for (vector<string>::iterator it = checked.begin();
+				it != checked.end(); ++it) {
+			argv.push_back(&(*it)[0]);
+		}
+		argv.push_back(NULL);
+		dcSimuParams params(argv.size() - 1, argv.data());
+	}
+	for (unsigned int c = 0; c < configurations.size(); c++) {
+		if (mkdir(folders[c].c_str(), 0755) != 0 && errno != EEXIST) {
+			cerr << "cannot create sweep folder " << folders[c] << endl;
+			exit(-1);
+		}
+	}
+
+	// Parse the application once, before forking the workers
+	vector<char *> argv = getArgv(0);
+	dcSimuParams params(argv.size() - 1, argv.data());
+	cout << "Parameter sweep of " << configurations.size()
+			<< " configurations on " << nbJobs << " workers" << endl;
+	int t0 = time(NULL);
+	parsedApplication app = parsedApplication();
+	traffic = !params.getTrafficPattern().empty();
+	replay = !params.getReplayFile().empty();
+	if (replay) {
+		trace = replaySystem::loadTrace(params.getReplayFile(),
+				params.getRows(), params.getCols());
+		cout << "    Trace loading time: " << (time(NULL) - t0) << " s" << endl;
+	} else if (!traffic) {
+		app = dcSystem::parseApplication(dcSystem::getApplicationFile(params),
+				params.getSeqDep());
+		cout << "    Parsing time: " << (time(NULL) - t0) << " s" << endl;
+	}
+
+	// Profile snapshots are asked to the workers, not to the sweep
+	signal(SIGUSR1, SIG_IGN);
+	map<pid_t, unsigned int> workers;
+	vector<int> status(configurations.size(), -1);
+	unsigned int next = 0;
+	while (next < configurations.size() || !workers.empty()) {
+		if (next < configurations.size() && workers.size() < nbJobs) {
+			cout.flush();
+			pid_t pid = fork();
+			if (pid < 0) {
+				cerr << "cannot fork sweep worker" << endl;
+				exit(-1);
+			} else if (pid == 0) {
+				exit(runConfiguration(next, app));
+			}
+			workers[pid] = next++;
+			continue;
+		}
+		int workerStatus;
+		pid_t pid = waitpid(-1, &workerStatus, 0);
+		if (pid < 0) {
+			break;
+		}
+		unsigned int c = workers[pid];
+		workers.erase(pid);
+		status[c] =
+				WIFEXITED(workerStatus) ? WEXITSTATUS(workerStatus) : -1;
+		cout << "    Configuration " << c << (status[c] == 0 ? "" : " failed")
+				<< " (" << folders[c] << ")" << endl;
+	}
+	writeSummary(status);
+	cout << "    Sweep time: " << (time(NULL) - t0) << " s" << endl;
+	for (vector<int>::iterator it = status.begin(); it != status.end(); ++it) {
+		if (*it != 0) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Simulate the given configuration in a worker process, its report
+ * goes to OUTPUT_Execution_Report.log and its results to
+ * OUTPUT_Summary.csv in its folder.
+ */
+int parameterSweep::runConfiguration(unsigned int configuration,
+		const parsedApplication &app) {
+	string folder = folders[configuration];
+	if (freopen((folder + "/OUTPUT_Execution_Report.log").c_str(), "w",
+			stdout) == NULL) {
+		cerr << "cannot write in sweep folder " << folder << endl;
+		return -1;
+	}
+	vector<char *> argv = getArgv(configuration);
+	dcSimuParams params(argv.size() - 1, argv.data());
+	sc_core::sc_report_handler::set_actions("/IEEE_Std_1666/deprecated",
+			sc_core::SC_DO_NOTHING);
+	sc_clock clock("my_clock", params.getCoresPeriodInNano(), SC_NS, 0.5);
+	if (traffic) {
+		return runTrafficConfiguration(configuration, params, clock);
+	} else if (replay) {
+		return runReplayConfiguration(configuration, params, clock);
+	}
+	dcSystem system("dcSsytem", params, &app);
+	system.clock(clock);
+	sc_start();
+
+	const simulationSummary &summary = system.getSummary();
+	ofstream f(folder + "/OUTPUT_Summary.csv");
+	f << summary.endTimeInNano << "," << summary.nbRunnablesCompleted << ","
+			<< summary.nbDeadlineMisses << "," << summary.nbPackets << ","
+			<< summary.simulationTimeInSec << endl;
+	f.close();
+	cout.flush();
+	return f ? 0 : -1;
+}
+
+/**
+ * Traffic characterization of the given configuration, its load-latency
+ * curve stays in its folder and its saturation point goes to
+ * OUTPUT_Summary.csv.
+ */
+int parameterSweep::runTrafficConfiguration(unsigned int configuration,
+		dcSimuParams &params, sc_clock &clock) {
+	trafficSystem system("trafficSystem", params);
+	system.clock(clock);
+	sc_start();
+
+	const trafficSummary &summary = system.getSummary();
+	ofstream f(folders[configuration] + "/OUTPUT_Summary.csv");
+	f << summary.saturationThroughput << "," << summary.saturationRate << ","
+			<< summary.zeroLoadLatencyInNano << "," << summary.nbPackets << ","
+			<< summary.simulationTimeInSec << endl;
+	f.close();
+	cout.flush();
+	return f ? 0 : -1;
+}
+
+/**
+ * Replay of the shared packet trace with the given configuration.
+ */
+int parameterSweep::runReplayConfiguration(unsigned int configuration,
+		dcSimuParams &params, sc_clock &clock) {
+	replaySystem system("replaySystem", params, &trace);
+	system.clock(clock);
+	sc_start();
+
+	const replaySummary &summary = system.getSummary();
+	ofstream f(folders[configuration] + "/OUTPUT_Summary.csv");
+	f << summary.nbPackets << "," << summary.nbDelivered << ","
+			<< summary.averageLatencyInNano << "," << summary.lastDeliveryInNano
+			<< "," << summary.simulationTimeInSec << endl;
+	f.close();
+	cout.flush();
+	return f ? 0 : -1;
+}
+
+/**
+ * Merge the results of the configurations in OUTPUT_Sweep_Summary.csv,
+ * and their load-latency curves in OUTPUT_Sweep_LoadLatency.csv for
+ * traffic characterizations.
+ */
+void parameterSweep::writeSummary(const vector<int> &status) {
+	ofstream f(outputFolder + "/OUTPUT_Sweep_Summary.csv");
+	f << "Configuration,Folder,";
+	for (vector<string>::iterator it = sweptOptions.begin();
+			it != sweptOptions.end(); ++it) {
+		f << *it << ",";
+	}
+	if (traffic) {
+		f << "Status,Saturation throughput,Saturation injection rate,"
+				"Zero-load latency(ns),Packets,Simulation time(s)" << endl;
+	} else if (replay) {
+		f << "Status,Packets,Delivered packets,Average latency(ns),"
+				"Last delivery(ns),Simulation time(s)" << endl;
+	} else {
+		f << "Status,Execution time(ns),Runnables executed,Deadline misses,"
+				"Packets,Simulation time(s)" << endl;
+	}
+	for (unsigned int c = 0; c < configurations.size(); c++) {
+		f << c << "," << folders[c] << ",";
+		for (vector<string>::iterator it = configurationValues[c].begin();
+				it != configurationValues[c].end(); ++it) {
+			f << *it << ",";
+		}
+		string results;
+		if (status[c] == 0) {
+			ifstream summary(folders[c] + "/OUTPUT_Summary.csv");
+			getline(summary, results);
+		}
+		f << (results.empty() ? "failed" : "ok") << "," << results << endl;
+	}
+	f.close();
+	if (!traffic) {
+		return;
+	}
+
+	ofstream curves(outputFolder + "/OUTPUT_Sweep_LoadLatency.csv");
+	for (unsigned int c = 0; c < configurations.size(); c++) {
+		ifstream curve(folders[c] + "/OUTPUT_Traffic_LoadLatency.csv");
+		string line;
+		for (unsigned int l = 0; getline(curve, line); l++) {
+			if (l > 0 || c == 0) {
+				curves << line << endl;
+			}
+		}
+	}
+	curves.close();
+}
+
+}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  END OF FILE.                                                              //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,81 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//                           DREAMCLOUD PROJECT                               //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DREAMCLOUD__PLATFORM_SCLIB__PARAMETERSWEEP_HXX
+#define DREAMCLOUD__PLATFORM_SCLIB__PARAMETERSWEEP_HXX
+
+////////////////////
+//    INCLUDES    //
+////////////////////
+#include <string>
+#include <vector>
+#include "dcSystem.hxx"
+#include "replaySystem.hxx"
+
+namespace dreamcloud {
+namespace platform_sclib {
+
+////////////////////
+//      USING     //
+////////////////////
+using std::string;
+using std::vector;
+
+/**
+ * Parameter sweep: when comma separated values are given to -policy,
+ * -bsize, -lrc, -rrc, -lwc, -rwc, -m or -freq, the simulation is run
+ * for each combination of values. The application is parsed once,
+ * then each configuration is simulated in a forked worker process
+ * sharing the parsed graph copy-on-write (a SystemC kernel can only
+ * elaborate one design). At most -jobs workers run at the same time,
+ * each one in the sweep_<configuration> subfolder of the output
+ * folder, and their results are merged in OUTPUT_Sweep_Summary.csv.
+ */
+class parameterSweep {
+
+public:
+	parameterSweep(int argc, char **argv);
+
+	unsigned int getNbConfigurations() const;
+
+	// Run all the configurations, return the process exit code
+	int run();
+
+private:
+	vector<char *> getArgv(unsigned int configuration);
+	int runConfiguration(unsigned int configuration,
+			const parsedApplication &app);
+	int runTrafficConfiguration(unsigned int configuration,
+			dcSimuParams &params, sc_clock &clock);
+	int runReplayConfiguration(unsigned int configuration,
+			dcSimuParams &params, sc_clock &clock);
+	void writeSummary(const vector<int> &status);
+
+	// Options with several values
+	vector<string> sweptOptions;
+
+	// Command line and swept values of each configuration
+	vector<vector<string> > configurations;
+	vector<vector<string> > configurationValues;
+	vector<string> folders;
+
+	string outputFolder;
+	unsigned int nbJobs;
+	bool traffic; // synthetic traffic characterizations
+	bool replay; // packet trace replays
+	vector<tracedPacket> trace; // loaded once like the application
+};
+
+}
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  END OF FILE.                                                              //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
@@ -8,8 +8,8 @@
 //    INCLUDES    //
 ////////////////////
 #include "processingElement.hxx"
+#include "checkpoint.hxx"
 #include <math.h> 
-#include <bitset>
 
 
 ////////////////////
@@ -20,8 +20,6 @@ using namespace std;
 namespace dreamcloud {
 namespace platform_sclib {
 
-int processingElement::nextPktId = 0;
-int processingElement::nextReadRequestId = 0;
 
 /**
  * Add the given runnable execution element to th ready list.
@@ -37,6 +35,43 @@ void processingElement::addReadyRunnable(runnableExecElement runnableExecElem) {
 			});
 }
 
+/**
+ * Return the key used to sort the given runnable among
+ * the ready ones (the lowest one runs first).
+ */
+int processingElement::getSchedulingPriority(dcRunnableInstance *run) {
+	if (sched == PRIO) {
+		return run->getRunCall()->GetPriority();
+	}
+	return run->GetMappingTime();
+}
+
+/**
+ * Change the frequency of the PE. The new frequency is used by the
+ * next instructions, which cannot start before the end of the
+ * transition. A transition starts once the previous one is over.
+ */
+void processingElement::setFrequencyInHz(unsigned long int frequencyInHz,
+		unsigned long int transitionInNano) {
+	if (frequencyInHz == type.getFrequencyInHz()) {
+		return;
+	}
+	type.setFrequencyInHz(frequencyInHz);
+	unsigned long int nowInNano = sc_time_stamp().value() / 1E3;
+	dvfsTransitionEndInNano = std::max(dvfsTransitionEndInNano, nowInNano)
+			+ transitionInNano;
+	nbDvfsTransitions++;
+}
+
+/**
+ * Set the initial frequency of the PE (operating point of its clock
+ * domain at start-up or restored from a checkpoint), which is not a
+ * frequency transition.
+ */
+void processingElement::initFrequencyInHz(unsigned long int frequencyInHz) {
+	type.setFrequencyInHz(frequencyInHz);
+}
+
 /**
  * Execute the given constant number of instructions by
  * waiting. Also log information for energy model.
@@ -45,15 +80,11 @@ void processingElement::executeInstructionsConstant(dcInstruction *inst,
 		dcRunnableInstance *run, int instructionId) {
 	dcExecutionCyclesConstantInstruction* einst =
 			static_cast<dcExecutionCyclesConstantInstruction*>(inst);
-	double waitTimeInNano = 1E9 * einst->GetValue()
-			* type.getNbCyclesPerInstructions() / type.getFrequencyInHz();
-	wait(waitTimeInNano, SC_NS);
-	string exeInstS = run->getRunCall()->GetRunClassName() + " ,"
-			+ std::to_string(instructionId) + " ,"
-			+ std::to_string(einst->GetValue()) + "\n";
+	double waitTimeInNano = getExecutionTimeInNano(einst->GetValue());
+	waitInstruction(waitTimeInNano);
 	computationTime += waitTimeInNano;
-	const char* exeInstS_const = exeInstS.c_str();
-	fputs(exeInstS_const, instsCsvFile);
+	countExecutedInstructions(run->getRunCall(), instructionId,
+			einst->GetValue());
 }
 
 /**
@@ -62,37 +93,83 @@ void processingElement::executeInstructionsConstant(dcInstruction *inst,
  */
 void processingElement::executeInstructionsDeviation(dcInstruction *inst,
 		dcRunnableInstance *run, int instructionId) {
-	dcExecutionCyclesDeviationInstruction* einst =
-			static_cast<dcExecutionCyclesDeviationInstruction*>(inst);
-	double UpperBound = 0.0;
-	double LowerBound = 0.0;
-	if (einst->GetUpperBoundValid()) {
-		UpperBound = einst->GetUpperBound();
-	}
-	if (einst->GetLowerBoundValid()) {
-		LowerBound = einst->GetLowerBound();
-	}
-	std::uniform_int_distribution<> distr(LowerBound, UpperBound);
-	int compute_duration = distr(gen);
-	double waitTimeInNano = 1E9 * compute_duration
-			* type.getNbCyclesPerInstructions() / type.getFrequencyInHz();
-	wait(waitTimeInNano, SC_NS);
+	unsigned long int compute_duration = sampleDeviation(inst);
+	double waitTimeInNano = getExecutionTimeInNano(compute_duration);
+	waitInstruction(waitTimeInNano);
 	computationTime += waitTimeInNano;
-	string exeInstS = run->getRunCall()->GetRunClassName() + " ,"
-			+ std::to_string(instructionId) + " ,"
-			+ std::to_string(compute_duration) + "\n";
-	const char* exeInstS_const = exeInstS.c_str();
-	fputs(exeInstS_const, instsCsvFile);
+	countExecutedInstructions(run->getRunCall(), instructionId,
+			compute_duration);
 }
 
-void processingElement::executeRemoteLabelRead(dcRemoteAccessInstruction *rinst,
-		dcRunnableInstance *run, int x, int y, int instructionId) {
+/**
+ * Draw the number of instructions of the given deviation instruction.
+ */
+unsigned long int processingElement::sampleDeviation(dcInstruction *inst) {
+	deviationParamsTable::iterator deviation = deviationParameters->find(inst);
+	if (deviation == deviationParameters->end()) {
+		deviation =
+				deviationParameters->insert(
+						std::make_pair(inst,
+								computeDeviationParams(
+										static_cast<dcExecutionCyclesDeviationInstruction*>(inst)))).first;
+	}
+	return sampler->sample(deviation->second);
+}
 
-	// Create packet representing read request
+/**
+ * Wait for the given execution time of the current instruction and
+ * remember when it ends for checkpoints.
+ */
+void processingElement::waitInstruction(double timeInNano) {
+	instructionEndInPico = sc_time_stamp().value() + llround(timeInNano * 1E3);
+	wait(timeInNano, SC_NS);
+}
+
+/**
+ * Add the executed instructions to the counters of the energy model
+ * and to the raw instructions log if enabled.
+ */
+void processingElement::countExecutedInstructions(dcRunnableCall *run,
+		int instructionId, unsigned long int nbInstructions) {
+	instructionCounters &counters = executedInstructions[std::make_pair(run,
+			instructionId)];
+	counters.nbExecutions++;
+	counters.nbInstructions += nbInstructions;
+	if (instsCsvFile != NULL) {
+		string exeInstS = run->GetRunClassName() + " ,"
+				+ std::to_string(instructionId) + " ,"
+				+ std::to_string(nbInstructions) + "\n";
+		fputs(exeInstS.c_str(), instsCsvFile);
+	}
+}
+
+/**
+ * Return the (x, y) location of the PE where the label accessed
+ * by the given instruction is mapped.
+ */
+std::pair<int, int> processingElement::getLabelLocation(
+		dcRemoteAccessInstruction *rinst) {
+	string labelName = rinst->GetLabel()->GetName();
+	vector<std::pair<std::pair<int, int>, string> >::iterator it;
+	it =
+			std::find_if(labelsMappingTable.begin(), labelsMappingTable.end(),
+					[&labelName](const std::pair< std::pair<int, int>, std::string >& pair)
+					{
+						return pair.second == labelName;
+					});
+	return it->first;
+}
+
+/**
+ * Create the packet representing a read request of the label
+ * accessed by the given instruction.
+ */
+Packet processingElement::createReadRequest(dcRemoteAccessInstruction *rinst,
+		dcRunnableInstance *run, int x, int y) {
 	Packet pck;
-	pck.set_id(nextPktId++);
+	pck.set_id(newPacketId());
 	pck.set_priority(run->getRunCall()->GetPriority());
-	pck.set_read_request_id(nextReadRequestId++);
+	pck.set_read_request_id(newReadRequestId());
 	pck.set_source(make_pair(x_PE, y_PE));
 	pck.set_destination(make_pair(x, y));
 	pck.set_rd_wr(false);
@@ -106,6 +183,20 @@ void processingElement::executeRemoteLabelRead(dcRemoteAccessInstruction *rinst,
 	pck.set_write_rq_ID(0);
 	nbRemRds++;
 	bytesRemRds += rinst->GetLabel()->GetSize();
+	if (cache != NULL) {
+		addLabelSharer(rinst->GetLabel()->GetID());
+	}
+	return pck;
+}
+
+void processingElement::executeRemoteLabelRead(dcRemoteAccessInstruction *rinst,
+		dcRunnableInstance *run, int x, int y, int instructionId) {
+
+	// Buffered writes to the same PE must reach it first
+	flushCombinedWrites(x, y);
+
+	// Create packet representing read request
+	Packet pck = createReadRequest(rinst, run, x, y);
 
 	// Put the runnable in the blocked list
 	// and remove it from the ready list
@@ -113,8 +204,8 @@ void processingElement::executeRemoteLabelRead(dcRemoteAccessInstruction *rinst,
 	responsePackets waitingParameters;
 	runnableExecStatus preemptedRStructure = std::make_pair(instructionId + 1,
 			run);
-	runnableExecElement preempted = std::make_pair(pck.get_read_request_id(),
-			preemptedRStructure);
+	blockedRunnableExecElement preempted = std::make_pair(
+			pck.get_read_request_id(), preemptedRStructure);
 	waitingParameters.first = pck.get_destination();
 	waitingParameters.second = 0;
 	blockedOnRemoteRead.first = waitingParameters;
@@ -132,28 +223,126 @@ void processingElement::executeRemoteLabelRead(dcRemoteAccessInstruction *rinst,
 	wait(PACKET_SIZE_IN_BYTES, SC_NS);
 
 	// Log runnable block in VCD file
-	if (params.getGenerateWaveforms()) {
-		unsigned long int nowInNano = sc_time_stamp().value() * 1E-3;
-		*runnablesVcdFile << "#" << nowInNano << endl;
-		*runnablesVcdFile << VCD_12_UNDEF << " " << VCD_ACTIVE_RUN_ID << x_PE
-				<< y_PE << endl;
-		*runnablesVcdFile << "1" << VCD_SUSPENDED_ON_REQUEST << x_PE << y_PE
-				<< endl;
+	logSuspendedOnRequest();
+}
+
+/**
+ * Execute a remote read for which a prefetch has been issued.
+ * If all the response packets have already been received, the
+ * label is read from the prefetch buffer at local read cost.
+ * Else the runnable is blocked until the remaining packets arrive.
+ * If no prefetch was issued for this instruction (all MSHRs were
+ * busy) a regular blocking remote read is executed.
+ * Return true if the runnable has been blocked.
+ */
+bool processingElement::executePrefetchedLabelRead(
+		dcRemoteAccessInstruction *rinst, dcRunnableInstance *run, int x, int y,
+		int instructionId) {
+	unsigned int resumeId = instructionId + 1;
+	vector<runnableBlockedOnRemoteRead>::iterator it =
+			std::find_if(labelPrefetches.begin(), labelPrefetches.end(),
+					[&run, &resumeId](const runnableBlockedOnRemoteRead& pf)
+					{
+						return pf.second.second.second.second == run && pf.second.second.second.first == resumeId;
+					});
+	if (it == labelPrefetches.end()) {
+		executeRemoteLabelRead(rinst, run, x, y, instructionId);
+		return true;
+	}
+	if (it->first.second == it->second.first) {
+		labelPrefetches.erase(it);
+		nbPrefetchHits++;
+		int localAccessSize = (int) (ceil(
+				double(rinst->GetLabel()->GetSize()) / double(8)));
+		waitInstruction(localAccessSize * params.getLocalReadCost());
+		return false;
 	}
+	nbPrefetchStalls++;
+	runnablesBlockedOnRemoteRead.push_back(*it);
+	labelPrefetches.erase(it);
+	removeReadyRunnable(run);
+	logSuspendedOnRequest();
+	return true;
 }
 
-void processingElement::executeRemoteLabelWrite(
-		dcRemoteAccessInstruction *rinst, dcRunnableInstance *run, int writeRequestId,
-		int x, int y) {
+/**
+ * Issue read requests for the remote labels read by the next
+ * instructions of the given runnable, as long as there are
+ * free MSHRs. Labels already requested are skipped thanks to
+ * the per runnable prefetch cursor.
+ */
+void processingElement::issueLabelPrefetches(dcRunnableInstance *run,
+		unsigned int instructionId) {
+	vector<dcInstruction *> instructions =
+			run->getRunCall()->GetAllInstructions();
+	unsigned int cursor = std::max(prefetchCursors[run], instructionId + 1);
+	while (cursor < instructions.size()
+			&& labelPrefetches.size() < params.getNbMshrs()) {
+		dcInstruction *inst = instructions.at(cursor);
+		cursor++;
+		if (inst->GetName() != "sw:LabelAccess") {
+			continue;
+		}
+		dcRemoteAccessInstruction *rinst =
+				static_cast<dcRemoteAccessInstruction*>(inst);
+		std::pair<int, int> loc = getLabelLocation(rinst);
+		if (rinst->GetWrite()
+				|| ((int) x_PE == loc.first && (int) y_PE == loc.second)
+				|| (cache != NULL && cache->contains(rinst->GetLabel()->GetID()))) {
+			continue;
+		}
+		flushCombinedWrites(loc.first, loc.second);
+		Packet pck = createReadRequest(rinst, run, loc.first, loc.second);
+		runnableBlockedOnRemoteRead prefetch;
+		prefetch.first = std::make_pair(pck.get_destination(), 0);
+		prefetch.second.first = pck.get_requestedSize();
+		prefetch.second.second = std::make_pair(pck.get_read_request_id(),
+				std::make_pair(cursor, run));
+		labelPrefetches.push_back(prefetch);
+		nbPrefetches++;
+		pck.set_injection_time();
+		pe_outputs.write(pck);
+		wait(PACKET_SIZE_IN_BYTES, SC_NS);
+	}
+	prefetchCursors[run] = cursor;
+}
 
-	int number_of_Packets = (int) (ceil(
-			double(rinst->GetLabel()->GetSize()) / double(8 * PACKET_SIZE_IN_BYTES)));
+/**
+ * Log in the waveforms that the active runnable has been suspended
+ * waiting for a remote read response.
+ */
+void processingElement::logSuspendedOnRequest() {
+	if (waves != NULL) {
+		waves->record(getPeIndex(), waveformWriter::ACTIVE_RUNNABLE,
+				sc_time_stamp().value(), waveformWriter::UNDEFINED);
+		waves->record(getPeIndex(), waveformWriter::SUSPENDED_ON_REQUEST,
+				sc_time_stamp().value());
+	}
+}
+
+void processingElement::executeRemoteLabelWrite(
+		dcRemoteAccessInstruction *rinst, dcRunnableInstance *run, int x, int y) {
 	nbRemWrs++;
 	bytesRemWrs += rinst->GetLabel()->GetSize();
+	sendWritePackets(x, y, run->getRunCall()->GetPriority(),
+			rinst->GetLabel()->GetSize());
+}
+
+/**
+ * Send a write of the given size to the given PE through the XBAR.
+ * The write is split in packets of PACKET_SIZE_IN_BYTES bytes.
+ */
+void processingElement::sendWritePackets(int x, int y, unsigned int priority,
+		unsigned long int nbBytes) {
+
+	int64_t writeRequestId = newWriteRequestId();
+	int number_of_Packets = (int) (ceil(
+			double(nbBytes) / double(8 * PACKET_SIZE_IN_BYTES)));
+	nbWritePktsSent += number_of_Packets;
 	for (int pkts = 0; pkts < number_of_Packets; pkts++) {
 		Packet pck;
-		pck.set_id(nextPktId++);
-		pck.set_priority(run->getRunCall()->GetPriority());
+		pck.set_id(newPacketId());
+		pck.set_priority(priority);
 		pck.set_source(make_pair(x_PE, y_PE));
 		pck.set_destination(make_pair(x, y));
 		pck.set_rd_wr(true);
@@ -177,6 +366,326 @@ void processingElement::executeRemoteLabelWrite(
 	sendPacket_event.notify();
 }
 
+/**
+ * Put a remote write in the write combining buffer. Writes to a
+ * destination which already has an open entry are merged in it,
+ * rewriting a label already in the entry doesn't add any byte.
+ * Storing into the buffer costs one remote write cost.
+ */
+void processingElement::executeCombinedLabelWrite(
+		dcRemoteAccessInstruction *rinst, dcRunnableInstance *run, int x, int y) {
+	nbRemWrs++;
+	bytesRemWrs += rinst->GetLabel()->GetSize();
+	std::pair<int, int> destination = std::make_pair(x, y);
+	vector<combinedWrite>::iterator entry = std::find_if(
+			writeCombiningBuffer.begin(), writeCombiningBuffer.end(),
+			[&destination](const combinedWrite& cw)
+			{
+				return cw.destination == destination;
+			});
+	if (entry == writeCombiningBuffer.end()) {
+		combinedWrite cw;
+		cw.destination = destination;
+		cw.openingTimeInNano = sc_time_stamp().value() / 1E3;
+		cw.nbBytes = 0;
+		cw.priority = 0;
+		cw.nbUncombinedPkts = 0;
+		writeCombiningBuffer.push_back(cw);
+		entry = writeCombiningBuffer.end() - 1;
+		writeCombining_event.notify();
+	} else {
+		nbCombinedWrites++;
+	}
+	dcLabel *label = rinst->GetLabel();
+	if (std::find(entry->labels.begin(), entry->labels.end(), label)
+			== entry->labels.end()) {
+		entry->labels.push_back(label);
+		entry->nbBytes += label->GetSize();
+	}
+	entry->priority = std::max(entry->priority,
+			(unsigned int) run->getRunCall()->GetPriority());
+	entry->nbUncombinedPkts += (unsigned int) (ceil(
+			double(rinst->GetLabel()->GetSize())
+					/ double(8 * PACKET_SIZE_IN_BYTES)));
+	waitInstruction(params.getRemoteWriteCost());
+}
+
+/**
+ * Send the combined writes pending for the given PE, if any.
+ * Used before reading a label from that PE so that the read
+ * doesn't overtake buffered writes.
+ */
+void processingElement::flushCombinedWrites(int x, int y) {
+	std::pair<int, int> destination = std::make_pair(x, y);
+	vector<combinedWrite>::iterator entry = std::find_if(
+			writeCombiningBuffer.begin(), writeCombiningBuffer.end(),
+			[&destination](const combinedWrite& cw)
+			{
+				return cw.destination == destination;
+			});
+	if (entry == writeCombiningBuffer.end()) {
+		return;
+	}
+	combinedWrite cw = *entry;
+	writeCombiningBuffer.erase(entry);
+	unsigned int nbPkts = (unsigned int) (ceil(
+			double(cw.nbBytes) / double(8 * PACKET_SIZE_IN_BYTES)));
+	nbCombinedWritePktsSent += nbPkts;
+	nbCombinedWritePktsSaved += cw.nbUncombinedPkts - nbPkts;
+	sendWritePackets(x, y, cw.priority, cw.nbBytes);
+
+	// The other copies of the labels are only stale once the writes
+	// leave the buffer
+	if (cache != NULL) {
+		for (vector<dcLabel *>::iterator it = cw.labels.begin();
+				it != cw.labels.end(); ++it) {
+			sendCoherencePackets(*it, cw.priority);
+		}
+	}
+}
+
+/**
+ * Free the MSHR of a prefetch which will not be consumed. The response
+ * packets still expected for it are ignored when they arrive.
+ */
+void processingElement::dropLabelPrefetch(
+		vector<runnableBlockedOnRemoteRead>::iterator prefetch) {
+	int64_t readRequestId = prefetch->second.second.first;
+	int remaining = prefetch->second.first - prefetch->first.second;
+	if (remaining > 0) {
+		droppedPrefetches[readRequestId] = remaining;
+		if (cache != NULL) {
+			releaseLabelSharer(getReadLabelId(*prefetch), readRequestId);
+		}
+	}
+	labelPrefetches.erase(prefetch);
+}
+
+/**
+ * Read a remote label from the label cache if it holds it.
+ * A hit costs a local read and saves the read request and
+ * response packets. Return false on a miss.
+ */
+bool processingElement::executeCachedLabelRead(
+		dcRemoteAccessInstruction *rinst, dcRunnableInstance *run,
+		int instructionId) {
+	if (cache == NULL) {
+		return false;
+	}
+	if (!cache->lookup(rinst->GetLabel()->GetID())) {
+		nbCacheMisses++;
+		return false;
+	}
+	nbCacheHits++;
+
+	// The prefetch of this read, if any, is not needed anymore
+	unsigned int resumeId = instructionId + 1;
+	vector<runnableBlockedOnRemoteRead>::iterator pf =
+			std::find_if(labelPrefetches.begin(), labelPrefetches.end(),
+					[&run, &resumeId](const runnableBlockedOnRemoteRead& pf)
+					{
+						return pf.second.second.second.second == run && pf.second.second.second.first == resumeId;
+					});
+	if (pf != labelPrefetches.end()) {
+		dropLabelPrefetch(pf);
+	}
+	nbCachePktsSaved += 1
+			+ (unsigned int) (ceil(
+					double(rinst->GetLabel()->GetSize())
+							/ double(8 * PACKET_SIZE_IN_BYTES)));
+	int localAccessSize = (int) (ceil(
+			double(rinst->GetLabel()->GetSize()) / double(8)));
+	waitInstruction(localAccessSize * params.getLocalReadCost());
+	return true;
+}
+
+/**
+ * Insert the label of a completed remote read in the label cache.
+ * The PE stays a sharer of the label in the global directory only if
+ * the label is cached or still being read. A read overtaken by a
+ * coherence packet for its label returned the old value, it does
+ * not fill the cache.
+ */
+void processingElement::fillLabelCache(
+		const runnableBlockedOnRemoteRead &completedRead) {
+	if (cache == NULL) {
+		return;
+	}
+	int64_t readRequestId = completedRead.second.second.first;
+	dcRunnableInstance *run = completedRead.second.second.second.second;
+	unsigned int instructionId = completedRead.second.second.second.first - 1;
+	dcRemoteAccessInstruction *rinst =
+			static_cast<dcRemoteAccessInstruction*>(run->getRunCall()->GetAllInstructions().at(
+					instructionId));
+	int labelId = rinst->GetLabel()->GetID();
+	if (staleLabelFills.erase(readRequestId) == 0) {
+		vector<int> evicted = cache->fill(labelId,
+				(unsigned long int) ceil(
+						double(rinst->GetLabel()->GetSize()) / 8));
+		for (vector<int>::iterator it = evicted.begin(); it != evicted.end();
+				++it) {
+			releaseLabelSharer(*it, -1);
+		}
+	}
+	releaseLabelSharer(labelId, readRequestId);
+}
+
+int processingElement::getReadLabelId(const runnableBlockedOnRemoteRead &read) {
+	dcRunnableInstance *run = read.second.second.second.second;
+	unsigned int instructionId = read.second.second.second.first - 1;
+	return static_cast<dcRemoteAccessInstruction*>(run->getRunCall()->GetAllInstructions().at(
+			instructionId))->GetLabel()->GetID();
+}
+
+// Return true if a read of the label, other than the given one, is
+// waiting for response packets
+bool processingElement::isLabelReadPending(int labelId,
+		int64_t exceptReadRequestId) {
+	for (vector<runnableBlockedOnRemoteRead>::iterator it =
+			runnablesBlockedOnRemoteRead.begin();
+			it != runnablesBlockedOnRemoteRead.end(); ++it) {
+		if (it->second.second.first != exceptReadRequestId
+				&& getReadLabelId(*it) == labelId) {
+			return true;
+		}
+	}
+	for (vector<runnableBlockedOnRemoteRead>::iterator it =
+			labelPrefetches.begin(); it != labelPrefetches.end(); ++it) {
+		if (it->second.second.first != exceptReadRequestId
+				&& it->first.second < it->second.first
+				&& getReadLabelId(*it) == labelId) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Leave the sharers of the label once it is neither cached nor read
+void processingElement::releaseLabelSharer(int labelId,
+		int64_t readRequestId) {
+	if (!cache->contains(labelId)
+			&& !isLabelReadPending(labelId, readRequestId)) {
+		removeLabelSharer(labelId, std::make_pair(x_PE, y_PE));
+	}
+}
+
+// The reads of the label in flight will return the old value
+void processingElement::markStaleLabelFills(int labelId) {
+	for (vector<runnableBlockedOnRemoteRead>::iterator it =
+			runnablesBlockedOnRemoteRead.begin();
+			it != runnablesBlockedOnRemoteRead.end(); ++it) {
+		if (getReadLabelId(*it) == labelId) {
+			staleLabelFills.insert(it->second.second.first);
+		}
+	}
+	for (vector<runnableBlockedOnRemoteRead>::iterator it =
+			labelPrefetches.begin(); it != labelPrefetches.end(); ++it) {
+		if (it->first.second < it->second.first
+				&& getReadLabelId(*it) == labelId) {
+			staleLabelFills.insert(it->second.second.first);
+		}
+	}
+}
+
+void processingElement::addLabelSharer(int labelId) {
+	vector<pair<int, int> > &sharers = (*labelSharers)[labelId];
+	pair<int, int> self = std::make_pair(x_PE, y_PE);
+	if (std::find(sharers.begin(), sharers.end(), self) == sharers.end()) {
+		sharers.push_back(self);
+	}
+}
+
+void processingElement::removeLabelSharer(int labelId, pair<int, int> sharer) {
+	vector<pair<int, int> > &sharers = (*labelSharers)[labelId];
+	sharers.erase(std::remove(sharers.begin(), sharers.end(), sharer),
+			sharers.end());
+}
+
+/**
+ * Keep label caches coherent after a write of a label by this PE.
+ * Each other PE holding a copy receives either one invalidation packet
+ * (and is removed from the directory) or the whole label as update
+ * packets. The local copy, if any, is written through.
+ */
+void processingElement::sendCoherencePackets(dcLabel *label,
+		unsigned int priority) {
+	int labelId = label->GetID();
+	bool invalidate = params.getLabelCacheCoherence() == "inv";
+	int number_of_Packets = 1;
+	if (!invalidate) {
+		number_of_Packets = (int) (ceil(
+				double(label->GetSize()) / double(8 * PACKET_SIZE_IN_BYTES)));
+	}
+	pair<int, int> self = std::make_pair(x_PE, y_PE);
+	vector<pair<int, int> > sharers = (*labelSharers)[labelId];
+	for (vector<pair<int, int> >::iterator it = sharers.begin();
+			it != sharers.end(); ++it) {
+		if (*it == self) {
+			continue;
+		}
+		if (invalidate) {
+			removeLabelSharer(labelId, *it);
+		}
+		for (int pkts = 0; pkts < number_of_Packets; pkts++) {
+			Packet pck;
+			pck.set_id(newPacketId());
+			pck.set_priority(priority);
+			pck.set_source(self);
+			pck.set_destination(*it);
+			pck.set_rd_wr(false);
+			pck.set_req_resp(false);
+			pck.set_requestedSize(0);
+			pck.set_read_request_id(-1);
+			pck.set_write_request_ID(0);
+			pck.set_write_rq_size(0);
+			pck.set_write_rq_ID(0);
+			pck.set_label_id(labelId);
+			pck.set_coherence(invalidate ? Packet::INVALIDATE : Packet::UPDATE);
+			pck.set_injection_time();
+			pe_outputs.write(pck);
+			nbCoherencePktsSent++;
+			wait(params.getRemoteWriteCost(), SC_NS);
+		}
+	}
+	if (cache != NULL) {
+		cache->lookup(labelId);
+	}
+}
+
+/**
+ * SystemC thread sending the write combining buffer entries
+ * into the XBAR once their combining window is over.
+ */
+void processingElement::writeCombiningFlusher_thread() {
+	while (true) {
+		profiler->activated(simulationProfiler::PE_WRITE_COMBINERS);
+		if (writeCombiningBuffer.empty()) {
+			wait(writeCombining_event);
+			continue;
+		}
+		unsigned long int nowInNano = sc_time_stamp().value() / 1E3;
+		unsigned long int expiry = writeCombiningBuffer.front().openingTimeInNano
+				+ params.getWriteCombiningWindow();
+		if (nowInNano < expiry && !writeCombiningDrained) {
+			wait(expiry - nowInNano, SC_NS);
+			continue;
+		}
+		std::pair<int, int> destination =
+				writeCombiningBuffer.front().destination;
+		flushCombinedWrites(destination.first, destination.second);
+	}
+}
+
+/**
+ * Send the entries of the write combining buffer without waiting for
+ * the end of their window, the next remote writes are not combined.
+ * Used at the end of the simulation so that no buffered write is lost.
+ */
+void processingElement::drainCombinedWrites() {
+	writeCombiningDrained = true;
+	writeCombining_event.notify();
+}
+
 /**
  * SC_METHOD sensitive to the packet_in port which
  * is connected to an sc_buffer. It handles the
@@ -192,17 +701,28 @@ void processingElement::executeRemoteLabelWrite(
  */
 void processingElement::pktReceiver_method() {
 	while (true) {
+		profiler->activated(simulationProfiler::PE_RECEIVERS);
 		while (pe_inputs.num_available() > 0) {
 
 			Packet p = pe_inputs.read();
 
 			// Dump the received packet
-			(*nocTrafficCsvFile) << p;
-			(*nocTrafficCsvFile).flush();
+			sinks->packetReceived(p);
+
+			// We receive a coherence packet for a label we may hold
+			// in our label cache
+			if (p.get_coherence() != Packet::NO_COHERENCE) {
+				nbCoherencePktsRcvd++;
+				if (p.get_coherence() == Packet::INVALIDATE) {
+					cache->invalidate(p.get_label_id());
+				}
+				markStaleLabelFills(p.get_label_id());
+			}
 
 			// We receive a request for a write to this PE from a remote PE
 			// TODO: ensure that we can remove this case
-			if (p.isWrite()) {
+			else if (p.isWrite()) {
+				nbWritePktsRcvd++;
 
 				if (p.get_write_rq_ID() == 0 && p.get_write_rq_size() > 0) {
 					writeRequests_in_process temp;
@@ -242,7 +762,7 @@ void processingElement::pktReceiver_method() {
 				int number_of_Packets = p.get_requestedSize();
 				for (int pkts = 0; pkts < number_of_Packets; pkts++) {
 					Packet pck;
-					pck.set_id(nextPktId++);
+					pck.set_id(newPacketId());
 					pck.set_priority(p.get_priority());
 					pck.set_read_request_id(p.get_read_request_id());
 					pck.set_source(p.get_destination());
@@ -265,7 +785,36 @@ void processingElement::pktReceiver_method() {
 // runnables list to the "ready" runnables one.
 			else if (!p.isWrite() && p.isReadResponse()) {
 				std::pair<int, int> source = p.get_source();
-				int readRequestId = p.get_read_request_id();
+				int64_t readRequestId = p.get_read_request_id();
+
+				// Responses to dropped prefetches are ignored
+				map<int64_t, int>::iterator dropped = droppedPrefetches.find(
+						readRequestId);
+				if (dropped != droppedPrefetches.end()) {
+					if (--(dropped->second) == 0) {
+						droppedPrefetches.erase(dropped);
+					}
+					continue;
+				}
+
+				// Responses to prefetches are only counted, the runnable
+				// will consume them when reaching the read instruction
+				vector<runnableBlockedOnRemoteRead>::iterator pf;
+				pf =
+						std::find_if(labelPrefetches.begin(),
+								labelPrefetches.end(),
+								[&source, &readRequestId](const runnableBlockedOnRemoteRead& pair)
+								{
+									return ((pair.first.first == source) && (pair.second.second.first == readRequestId));
+								});
+				if (pf != labelPrefetches.end()) {
+					(pf->first.second)++;
+					if (pf->first.second == pf->second.first) {
+						fillLabelCache(*pf);
+					}
+					continue;
+				}
+
 				vector<runnableBlockedOnRemoteRead>::iterator it;
 				it =
 						std::find_if(runnablesBlockedOnRemoteRead.begin(),
@@ -288,7 +837,11 @@ void processingElement::pktReceiver_method() {
 				// unblock the runnable.
 				(it->first.second)++;
 				if (it->first.second == it->second.first) {
-					addReadyRunnable(it->second.second);
+					fillLabelCache(*it);
+					dcRunnableInstance *run = it->second.second.second.second;
+					addReadyRunnable(
+							std::make_pair(getSchedulingPriority(run),
+									it->second.second.second));
 					runnablesBlockedOnRemoteRead.erase(it);
 					newRunnable_event->notify();
 				}
@@ -304,43 +857,36 @@ void processingElement::pktReceiver_method() {
  */
 void processingElement::runnableExecuter_thread() {
 
-	int writeRequestId = 0;
-
 	while (true) {
 
 		// Wait for runnables from dcSystem
 		if (readyRunnables.empty() && !newRunnableSignal) {
 			wait(*newRunnable_event);
 		}
+		profiler->activated(simulationProfiler::PE_EXECUTERS);
 
 		// If a new runnable has been sent during the execution of the last instruction
 		// Put it in the ready list
 		// ONE clock cycle
 		if (newRunnableSignal) {
 			runnableExecStatus execStatus = std::make_pair(0, newRunnable);
-			int prio;
-			if (sched == PRIO) {
-				prio = newRunnable->getRunCall()->GetPriority();
-			} else if (sched == FCFS) {
-				prio = newRunnable->GetMappingTime();
-			}
+			int prio = getSchedulingPriority(newRunnable);
 			newRunnable->SetCoreReceiveTime(sc_time_stamp().value());
 			runnableExecElement execElement = std::make_pair(prio, execStatus);
 			addReadyRunnable(execElement);
 
-			// Log runnable preemption in VCD file
-			unsigned long int nowInNano = sc_time_stamp().value() * 1E-3;
-			if (params.getGenerateWaveforms()) {
+			// Log runnable preemption in the waveforms
+			if (waves != NULL) {
 				if (readyRunnables.size() > 1
 						&& readyRunnables.front().second.second->GetUniqueID()
 								== newRunnable->GetUniqueID()) {
-					*runnablesVcdFile << "#" << nowInNano << endl;
-					*runnablesVcdFile << "1" << VCD_PREEMPTION << x_PE << y_PE
-							<< endl;
+					waves->record(getPeIndex(), waveformWriter::PREEMPTION,
+							sc_time_stamp().value());
 				}
 			}
 
 			newRunnableSignal = false;
+			runnableConsumed_event->notify();
 			wait(1, SC_NS);
 		}
 
@@ -354,15 +900,33 @@ void processingElement::runnableExecuter_thread() {
 				currentRunnable->getRunCall()->GetAllInstructions();
 		unsigned int nbInstructions = instructions.size();
 		bool blockedOnRemoteRead = false;
+		executingRunnable = currentRunnable;
 
-		// Move to next instruction for next time this runnable will be executed
-		readyRunnables.front().second.first++;
+		// A runnable restored from a checkpoint first waits for the end
+		// of the instruction it was executing
+		bool resumed = currentRunnable == resumedRunnable;
+		if (resumed) {
+			resumedRunnable = NULL;
+			instructionId--;
+			wait(resumedRemainingInPico, SC_PS);
+		} else {
+			// Move to next instruction for next time this runnable will be executed
+			readyRunnables.front().second.first++;
+		}
 
 		// If the next instruction to execute exists.
 		// This checks is required because when we block a runnable
 		// on a remote read and its the last instruction, when we unblock it
 		// we are above the last instruction
-		if (instructionId < nbInstructions) {
+		if (!resumed && instructionId < nbInstructions) {
+
+			// Stall until the end of the frequency transition if any
+			unsigned long int nowInNano = sc_time_stamp().value() / 1E3;
+			if (dvfsTransitionEndInNano > nowInNano) {
+				wait(dvfsTransitionEndInNano - nowInNano, SC_NS);
+				dvfsTransitionTime += dvfsTransitionEndInNano - nowInNano;
+			}
+
 			dcInstruction* inst = instructions.at(instructionId);
 			string instrName = inst->GetName();
 			unsigned long int nowInPico = sc_time_stamp().value();
@@ -370,12 +934,15 @@ void processingElement::runnableExecuter_thread() {
 				currentRunnable->SetStartTime(nowInPico);
 			}
 
-			// Log runnable activation in VCD file
-			if (params.getGenerateWaveforms()) {
-				std::bitset<12> binId(
-						currentRunnable->getRunCall()->GetWaveID());
-				*runnablesVcdFile << "#" << (nowInPico * 1E-3) << " b" << binId
-						<< " " << VCD_ACTIVE_RUN_ID << x_PE << y_PE << endl;
+			// Log runnable activation in the waveforms
+			if (waves != NULL) {
+				waves->record(getPeIndex(), waveformWriter::ACTIVE_RUNNABLE,
+						nowInPico, currentRunnable->getRunCall()->GetWaveID());
+			}
+
+			// Issue reads of the upcoming remote labels while MSHRs are free
+			if (params.getNbMshrs() > 0) {
+				issueLabelPrefetches(currentRunnable, instructionId);
 			}
 
 			// Label accesses
@@ -384,17 +951,9 @@ void processingElement::runnableExecuter_thread() {
 				// Search where is the label
 				dcRemoteAccessInstruction *rinst =
 						static_cast<dcRemoteAccessInstruction*>(inst);
-				string labelName = rinst->GetLabel()->GetName();
-				vector<std::pair<std::pair<int, int>, string> >::iterator it;
-				it =
-						std::find_if(labelsMappingTable.begin(),
-								labelsMappingTable.end(),
-								[&labelName](const std::pair< std::pair<int, int>, std::string >& pair)
-								{
-									return pair.second == labelName;
-								});
-				unsigned int destX = it->first.first;
-				unsigned int destY = it->first.second;
+				std::pair<int, int> loc = getLabelLocation(rinst);
+				unsigned int destX = loc.first;
+				unsigned int destY = loc.second;
 
 				// Local read and write accesses
 				// ONE clock cycle per byte
@@ -402,32 +961,68 @@ void processingElement::runnableExecuter_thread() {
 					int localAccessSize = (int) (ceil(
 							double(rinst->GetLabel()->GetSize()) / double(8)));
 					if (rinst->GetWrite()) {
-						wait(localAccessSize * params.getLocalWriteCost(), SC_NS);
+						waitInstruction(
+								localAccessSize * params.getLocalWriteCost());
 						nbLocWrs++;
 						bytesLocWrs += rinst->GetLabel()->GetSize();
 					} else {
-						wait(localAccessSize * params.getLocalReadCost(), SC_NS);
+						waitInstruction(
+								localAccessSize * params.getLocalReadCost());
 						nbLocRds++;
 						bytesLocRds += rinst->GetLabel()->GetSize();
 					}
 				}
 
+				// Remote read of a label held in the label cache
+				// LOCAL read cost, no packet sent
+				else if (!rinst->GetWrite()
+						&& executeCachedLabelRead(rinst, currentRunnable,
+								instructionId)) {
+					// Nothing else to do
+				}
+
 				// Remote write: sent packets according to the size of the label
 				// nbPackets * PACKET_SIZE clock cycles
+				else if (rinst->GetWrite()
+						&& (params.getWriteCombiningWindow() == 0
+								|| writeCombiningDrained)) {
+					executeRemoteLabelWrite(rinst, currentRunnable, destX,
+							destY);
+				}
+
+				// Remote write with write combining: merge it in the
+				// buffer entry of the destination PE
 				else if (rinst->GetWrite()) {
-					executeRemoteLabelWrite(rinst, currentRunnable,
-							writeRequestId, destX, destY);
-					writeRequestId++;
+					executeCombinedLabelWrite(rinst, currentRunnable, destX,
+							destY);
 				}
 
 				// Remote read: send one packet including information allowing
 				// receiver to send response back
 				// PACKET_SIZE clock cycles
-				else if (!rinst->GetWrite()) {
+				else if (!rinst->GetWrite() && params.getNbMshrs() == 0) {
 					executeRemoteLabelRead(rinst, currentRunnable, destX, destY,
 							instructionId);
 					blockedOnRemoteRead = true;
 				}
+
+				// Remote read with MSHRs: consume the prefetched label
+				// (or send the request if it has not been prefetched)
+				else if (!rinst->GetWrite()) {
+					blockedOnRemoteRead = executePrefetchedLabelRead(rinst,
+							currentRunnable, destX, destY, instructionId);
+				}
+
+				// Invalidate or update the copies of the written label
+				// held by other PEs label caches, combined writes do it
+				// when they leave the buffer
+				if (rinst->GetWrite() && cache != NULL
+						&& (params.getWriteCombiningWindow() == 0
+								|| writeCombiningDrained
+								|| ((x_PE == destX) && (y_PE == destY)))) {
+					sendCoherencePackets(rinst->GetLabel(),
+							currentRunnable->getRunCall()->GetPriority());
+				}
 			} // End label access
 
 			// Instruction constant
@@ -444,73 +1039,55 @@ void processingElement::runnableExecuter_thread() {
 		if (!blockedOnRemoteRead
 				&& (instructionId >= nbInstructions - 1 || nbInstructions == 0)) {
 
-			// Log runnable info in CSV file and arff
+			// Log runnable info in the output sinks
 			currentRunnable->SetCompletionTime(sc_time_stamp().value());
 			unsigned long int runnableExecutionTime =
 					currentRunnable->GetCompletionTime()
 							- currentRunnable->GetCoreReceiveTime();
-			(*runnablesCsvFile) << "PE" << x_PE << y_PE << ",";
-			(*runnablesCsvFile)
-					<< currentRunnable->getRunCall()->GetRunClassName() << ",";
-			(*runnablesCsvFile) << currentRunnable->getRunCall()->GetPriority()
-					<< ",";
-			(*runnablesCsvFile) << (currentRunnable->GetMappingTime() / 1E3)
-					<< ",";
-			(*runnablesCsvFile) << (currentRunnable->GetStartTime() / 1E3)
-					<< ",";
-			(*runnablesCsvFile) << (currentRunnable->GetCompletionTime() / 1E3)
-					<< ",";
-			(*runnablesCsvFile) << (runnableExecutionTime / 1E3) << ",";
-			(*runnablesCsvFile)
-					<< (currentRunnable->getRunCall()->GetDeadlineValueInNano())
-					<< ",";
-			(*runnablesCsvFile)
-					<< (currentRunnable->getRunCall()->GetDeadlineValueInNano()
-							- (runnableExecutionTime / 1E3)) << endl;
-			(*runnablesArffFile) << "PE" << x_PE << y_PE << ",";
-			(*runnablesArffFile) << fixed
-					<< currentRunnable->getRunCall()->GetRunClassName() << ",";
-			(*runnablesArffFile) << fixed
-					<< currentRunnable->getRunCall()->GetPriority() << ",";
-			(*runnablesArffFile) << fixed
-					<< (currentRunnable->GetMappingTime() / 1E3) << ",";
-			(*runnablesArffFile) << fixed
-					<< (currentRunnable->GetStartTime() / 1E3) << ",";
-			(*runnablesArffFile) << fixed
-					<< (currentRunnable->GetCompletionTime() / 1E3) << ",";
-			(*runnablesArffFile) << fixed << (runnableExecutionTime / 1E3)
-					<< ",";
-			(*runnablesArffFile) << fixed
-					<< (currentRunnable->getRunCall()->GetDeadlineValueInNano()
-							/ 1E3) << ",";
-			(*runnablesArffFile) << fixed
-					<< (currentRunnable->getRunCall()->GetDeadlineValueInNano()
-							- (runnableExecutionTime / 1E3)) << endl;
-
-			// Log runnable complete in VCD file
-			unsigned long int nowInNano = sc_time_stamp().value() * 1E-3;
-			if (params.getGenerateWaveforms()) {
-				*runnablesVcdFile << "#" << nowInNano << endl;
-				*runnablesVcdFile << VCD_12_UNDEF << " " << VCD_ACTIVE_RUN_ID
-						<< x_PE << y_PE << endl;
-				*runnablesVcdFile << "1" << VCD_RUNNABLE_COMPLETED << x_PE
-						<< y_PE << endl;
+			sinks->runnableCompleted(currentRunnable, x_PE, y_PE,
+					runnableExecutionTime);
+
+			// Log runnable complete in the waveforms
+			if (waves != NULL) {
+				waves->record(getPeIndex(), waveformWriter::ACTIVE_RUNNABLE,
+						sc_time_stamp().value(), waveformWriter::UNDEFINED);
+				waves->record(getPeIndex(), waveformWriter::RUNNABLE_COMPLETED,
+						sc_time_stamp().value());
+			}
+
+			// Record the slack left for the DVFS governor
+			double deadline =
+					currentRunnable->getRunCall()->GetDeadlineValueInNano();
+			if (deadline > 0) {
+				double slackRatio = (deadline - runnableExecutionTime * 1E-3)
+						/ deadline;
+				if (slackRatio < dvfsMinSlackRatio) {
+					dvfsMinSlackRatio = slackRatio;
+				}
 			}
 
 			// Check deadline miss
 			if (runnableExecutionTime * 1E-3
 					> currentRunnable->getRunCall()->GetDeadlineValueInNano()) {
 				deadlinesMissed++;
-				if (params.getGenerateWaveforms()) {
-					*runnablesVcdFile << "1" << VCD_DEADLINE_MISSED << x_PE
-							<< y_PE << endl;
+				dvfsDeadlinesMissed++;
+				if (waves != NULL) {
+					waves->record(getPeIndex(), waveformWriter::DEADLINE_MISSED,
+							sc_time_stamp().value());
 				}
 			}
 
 			// Add the completed runnable to completed queue and remove it from ready one
-			completedRunInstances.push_back(currentRunnable);
+			completedRunInstances->push_back(currentRunnable);
 			(*runnableCompleted_event).notify(SC_ZERO_TIME);
 			removeReadyRunnable(currentRunnable);
+			prefetchCursors.erase(currentRunnable);
+			for (unsigned int i = labelPrefetches.size(); i > 0; i--) {
+				if (labelPrefetches[i - 1].second.second.second.second
+						== currentRunnable) {
+					dropLabelPrefetch(labelPrefetches.begin() + i - 1);
+				}
+			}
 		}
 	}
 }
@@ -530,6 +1107,232 @@ void processingElement::removeReadyRunnable(dcRunnableInstance *runnable) {
 	readyRunnables.erase(toRemove);
 }
 
+/**
+ * Functional execution of the given runnables the given number of
+ * times, without simulated time nor packets. Deviation instructions
+ * are drawn from the sampler of the PE and instructions and label
+ * accesses are counted as a timed execution would, label caches,
+ * prefetches and write combining are not modelled.
+ */
+void processingElement::fastForward(const vector<dcRunnableCall *> &runnables,
+		unsigned long int nbTimes) {
+	for (unsigned long int i = 0; i < nbTimes; i++) {
+		for (vector<dcRunnableCall *>::const_iterator run = runnables.begin();
+				run != runnables.end(); ++run) {
+			vector<dcInstruction *> instructions = (*run)->GetAllInstructions();
+			for (unsigned int id = 0; id < instructions.size(); id++) {
+				dcInstruction *inst = instructions.at(id);
+				string instrName = inst->GetName();
+				unsigned long int nbInstructions;
+				if (instrName == "sw:InstructionsConstant") {
+					nbInstructions =
+							static_cast<dcExecutionCyclesConstantInstruction*>(inst)->GetValue();
+				} else if (instrName == "sw:InstructionsDeviation") {
+					nbInstructions = sampleDeviation(inst);
+				} else {
+					if (instrName == "sw:LabelAccess") {
+						countLabelAccess(
+								static_cast<dcRemoteAccessInstruction*>(inst));
+					}
+					continue;
+				}
+				computationTime += getExecutionTimeInNano(nbInstructions);
+				countExecutedInstructions(*run, id, nbInstructions);
+			}
+		}
+	}
+}
+
+/**
+ * Count a label access of a fast-forwarded runnable.
+ */
+void processingElement::countLabelAccess(dcRemoteAccessInstruction *rinst) {
+	std::pair<int, int> loc = getLabelLocation(rinst);
+	unsigned long int size = rinst->GetLabel()->GetSize();
+	bool local = (int) x_PE == loc.first && (int) y_PE == loc.second;
+	if (local && rinst->GetWrite()) {
+		nbLocWrs++;
+		bytesLocWrs += size;
+	} else if (local) {
+		nbLocRds++;
+		bytesLocRds += size;
+	} else if (rinst->GetWrite()) {
+		nbRemWrs++;
+		bytesRemWrs += size;
+	} else {
+		nbRemRds++;
+		bytesRemRds += size;
+	}
+}
+
+/**
+ * Write the state of the PE in a checkpoint. Runnables blocked on a
+ * remote read are saved at the read instruction so that they issue it
+ * again once restored. The runnable executing an instruction saves
+ * the time left to it. The packets in flight, pending prefetches and
+ * combined writes are not saved.
+ */
+void processingElement::saveState(ostream &os,
+		const map<dcRunnableCall *, unsigned int> &runnableIndexes) {
+	os << "pe " << getPeIndex() << endl;
+	os << "stats " << nbLocRds << " " << nbLocWrs << " " << nbRemRds << " "
+			<< nbRemWrs << " " << bytesLocRds << " " << bytesLocWrs << " "
+			<< bytesRemRds << " " << bytesRemWrs << " " << computationTime
+			<< " " << nbPrefetches << " " << nbPrefetchHits << " "
+			<< nbPrefetchStalls << " " << nbCombinedWrites << " "
+			<< nbCombinedWritePktsSent << " " << nbCombinedWritePktsSaved
+			<< " " << nbCacheHits << " " << nbCacheMisses << " "
+			<< nbCachePktsSaved << " " << nbCoherencePktsSent << " "
+			<< nbCoherencePktsRcvd << " " << nbDvfsTransitions << " "
+			<< dvfsTransitionTime << " " << deadlinesMissed << endl;
+	os << "sequences " << nextPktSeq << " " << nextReadRequestSeq << " "
+			<< nextWriteRequestSeq << endl;
+	os << "sampler ";
+	sampler->saveState(os);
+	os << endl;
+
+	vector<pair<int, unsigned long int> > cachedLabels;
+	if (cache != NULL) {
+		cachedLabels = cache->getLabels();
+	}
+	os << "cache " << cachedLabels.size();
+	for (vector<pair<int, unsigned long int> >::iterator it =
+			cachedLabels.begin(); it != cachedLabels.end(); ++it) {
+		os << " " << it->first << " " << it->second;
+	}
+	os << endl;
+
+	vector<runnableExecStatus> runs;
+	for (vector<runnableExecElement>::iterator it = readyRunnables.begin();
+			it != readyRunnables.end(); ++it) {
+		runs.push_back(it->second);
+	}
+	for (vector<runnableBlockedOnRemoteRead>::iterator it =
+			runnablesBlockedOnRemoteRead.begin();
+			it != runnablesBlockedOnRemoteRead.end(); ++it) {
+		runnableExecStatus blocked = it->second.second.second;
+		runs.push_back(std::make_pair(blocked.first - 1, blocked.second));
+	}
+	os << "runnables " << runs.size() << endl;
+	for (vector<runnableExecStatus>::iterator it = runs.begin();
+			it != runs.end(); ++it) {
+		dcRunnableInstance *run = it->second;
+		unsigned long int remainingInPico = 0;
+		if (run == executingRunnable
+				&& instructionEndInPico > sc_time_stamp().value()) {
+			remainingInPico = instructionEndInPico - sc_time_stamp().value();
+		}
+		os << runnableIndexes.at(run->getRunCall()) << " " << it->first << " "
+				<< run->GetReleaseTime() << " " << run->GetMappingTime() << " "
+				<< run->GetCoreReceiveTime() << " " << run->GetStartTime() << " "
+				<< remainingInPico << endl;
+	}
+
+	os << "executed " << executedInstructions.size() << endl;
+	for (map<pair<dcRunnableCall *, int>, instructionCounters>::iterator it =
+			executedInstructions.begin(); it != executedInstructions.end();
+			++it) {
+		os << runnableIndexes.at(it->first.first) << " " << it->first.second
+				<< " " << it->second.nbExecutions << " "
+				<< it->second.nbInstructions << endl;
+	}
+}
+
+/**
+ * Restore the state written by saveState. The PE must not have
+ * received any runnable yet.
+ */
+void processingElement::restoreState(istream &is,
+		const vector<dcRunnableCall *> &runnables, runnableInstancePool &pool) {
+	unsigned int peIndex;
+	readCheckpointKey(is, "pe");
+	is >> peIndex;
+	if (peIndex != getPeIndex()) {
+		cerr << "invalid checkpoint: state of PE " << peIndex
+				<< " found instead of PE " << getPeIndex() << endl;
+		exit(-1);
+	}
+	readCheckpointKey(is, "stats");
+	is >> nbLocRds >> nbLocWrs >> nbRemRds >> nbRemWrs >> bytesLocRds
+			>> bytesLocWrs >> bytesRemRds >> bytesRemWrs >> computationTime
+			>> nbPrefetches >> nbPrefetchHits >> nbPrefetchStalls
+			>> nbCombinedWrites >> nbCombinedWritePktsSent
+			>> nbCombinedWritePktsSaved >> nbCacheHits >> nbCacheMisses
+			>> nbCachePktsSaved >> nbCoherencePktsSent >> nbCoherencePktsRcvd
+			>> nbDvfsTransitions >> dvfsTransitionTime >> deadlinesMissed;
+	readCheckpointKey(is, "sequences");
+	is >> nextPktSeq >> nextReadRequestSeq >> nextWriteRequestSeq;
+	readCheckpointKey(is, "sampler");
+	sampler->restoreState(is);
+
+	// Labels are cached again in LRU order, which also works with
+	// another cache geometry
+	unsigned int nbCachedLabels;
+	readCheckpointKey(is, "cache");
+	is >> nbCachedLabels;
+	for (unsigned int i = 0; i < nbCachedLabels; i++) {
+		int labelId;
+		unsigned long int sizeInBytes;
+		is >> labelId >> sizeInBytes;
+		if (cache != NULL) {
+			vector<int> evicted = cache->fill(labelId, sizeInBytes);
+			for (vector<int>::iterator it = evicted.begin();
+					it != evicted.end(); ++it) {
+				removeLabelSharer(*it, std::make_pair(x_PE, y_PE));
+			}
+			if (cache->contains(labelId)) {
+				addLabelSharer(labelId);
+			}
+		}
+	}
+
+	unsigned int nbRunnables;
+	readCheckpointKey(is, "runnables");
+	is >> nbRunnables;
+	for (unsigned int i = 0; i < nbRunnables; i++) {
+		unsigned int runIndex, instructionId;
+		unsigned long int releaseTime, mappingTime, coreReceiveTime, startTime,
+				remainingInPico;
+		is >> runIndex >> instructionId >> releaseTime >> mappingTime
+				>> coreReceiveTime >> startTime >> remainingInPico;
+		if (!is || runIndex >= runnables.size()) {
+			cerr << "invalid checkpoint: bad runnable in PE " << peIndex
+					<< endl;
+			exit(-1);
+		}
+		dcRunnableInstance *run = pool.create(runnables.at(runIndex));
+		run->SetReleaseTime(releaseTime);
+		run->SetMappingTime(mappingTime);
+		run->SetCoreReceiveTime(coreReceiveTime);
+		run->SetStartTime(startTime);
+		addReadyRunnable(
+				std::make_pair(getSchedulingPriority(run),
+						std::make_pair(instructionId, run)));
+		if (remainingInPico > 0) {
+			resumedRunnable = run;
+			resumedRemainingInPico = remainingInPico;
+		}
+	}
+
+	unsigned int nbCounters;
+	readCheckpointKey(is, "executed");
+	is >> nbCounters;
+	for (unsigned int i = 0; i < nbCounters; i++) {
+		unsigned int runIndex;
+		int instructionId;
+		instructionCounters counters;
+		is >> runIndex >> instructionId >> counters.nbExecutions
+				>> counters.nbInstructions;
+		if (!is || runIndex >= runnables.size()) {
+			cerr << "invalid checkpoint: bad instruction counter in PE "
+					<< peIndex << endl;
+			exit(-1);
+		}
+		executedInstructions[std::make_pair(runnables.at(runIndex),
+				instructionId)] = counters;
+	}
+}
+
 }
 }
 
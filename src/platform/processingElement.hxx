@@ -20,8 +20,16 @@
 #include "dcSimuParams.hxx"
 #include "commons/parser/dcRunnableInstance.h"
 #include "processingElementType.hxx"
+#include "outputSink.hxx"
+#include "waveformWriter.hxx"
+#include "runnableInstancePool.hxx"
+#include "labelCache.hxx"
+#include "deviationSampler.hxx"
+#include "simulationProfiler.hxx"
 #include <algorithm>
 #include <vector>
+#include <map>
+#include <set>
 #include "xbar/lib/xbar_sc_fifo_ports.h"
 
 namespace dreamcloud {
@@ -33,14 +41,6 @@ namespace platform_sclib {
 using dreamcloud::platform_sclib::noc_ppa::Packet;
 using namespace DCApplication;
 
-// Constants for VCD file generation
-const string VCD_ACTIVE_RUN_ID("!");
-const string VCD_SUSPENDED_ON_REQUEST("{");
-const string VCD_PREEMPTION("[");
-const string VCD_RUNNABLE_COMPLETED("*");
-const string VCD_DEADLINE_MISSED("(");
-const string VCD_12_UNDEF("bxxxxxxxxxxxx");
-
 class processingElement: sc_module {
 public:
 
@@ -59,28 +59,40 @@ public:
 	sc_event *newRunnable_event;
 
 	sc_event *runnableCompleted_event;
+	sc_event *runnableConsumed_event;
 	sc_event *packetToSend_event;
 
 	unsigned int x_PE, y_PE;
 
 	int deadlinesMissed = 0;
-	vector<dcRunnableInstance *> completedRunInstances;
+	// Completion queue shared by all the PEs and emptied by dcSystem
+	vector<dcRunnableInstance *> *completedRunInstances;
+
+	// Executed instructions for the energy model, per (runnable, instruction index)
+	typedef struct instructionCounters {
+		unsigned long int nbExecutions;
+		unsigned long int nbInstructions;
+	} instructionCounters;
+	map<pair<dcRunnableCall *, int>, instructionCounters> executedInstructions;
 
 	// Global labels mapping table
 	vector<std::pair<std::pair<int, int>, string> > labelsMappingTable;
 
+	// Global directory of label copies held in PEs label caches
+	labelSharersTable *labelSharers;
+
+	// Global sampling parameters of deviation instructions
+	deviationParamsTable *deviationParameters;
+
+	// Simulator performance counters shared by all the modules
+	simulationProfiler *profiler;
+
 	// Scheduling strategy
 	enum SchedulingStrategy {
 		FCFS, PRIO
 	};
 	const SchedulingStrategy sched;
 
-	// Packet ids (unique ID for EACH packet sent to the crossbar)
-	static int nextPktId;
-
-	// Packet ids (unique ID for EACH read request)
-	static int nextReadRequestId;
-
 	// Statistics about what happened on the core
 	unsigned int nbLocRds;
 	unsigned int nbLocWrs;
@@ -91,48 +103,115 @@ public:
 	unsigned long int bytesRemRds;
 	unsigned long int bytesRemWrs;
 	unsigned long int computationTime;
+	unsigned int nbPrefetches;
+	unsigned int nbPrefetchHits;
+	unsigned int nbPrefetchStalls;
+	unsigned int nbCombinedWrites;
+	unsigned int nbCombinedWritePktsSent;
+	unsigned int nbCombinedWritePktsSaved;
+	unsigned int nbCacheHits;
+	unsigned int nbCacheMisses;
+	unsigned int nbCachePktsSaved;
+	unsigned int nbCoherencePktsSent;
+	unsigned int nbCoherencePktsRcvd;
+	unsigned int nbDvfsTransitions;
+	unsigned long int dvfsTransitionTime;
+
+	// Write packets sent (counted when the write starts) and received,
+	// used to wait for the delivery of the writes at the end
+	unsigned long int nbWritePktsSent = 0;
+	unsigned long int nbWritePktsRcvd = 0;
+
+	// Activity since the last DVFS governor period, reset by dcSystem
+	double dvfsMinSlackRatio;
+	unsigned int dvfsDeadlinesMissed;
 
 	SC_HAS_PROCESS(processingElement);
 	processingElement(sc_module_name name, FILE *constInstsCsvFile_,
-			ofstream *nocTrafficCsvFile_, ofstream *nocTrafficArffFile_,
-			ofstream *runnablesCsvFile_, ofstream *runnablesArffFile_,
-			ofstream *runnablesVcdFile_, SchedulingStrategy sched_,
-			dcSimuParams params_, unsigned long int nbCyclesPerInstructions) :
+			outputSinks *sinks_, waveformWriter *waves_,
+			SchedulingStrategy sched_,
+			dcSimuParams params_, processingElementType type_) :
 			sc_module(name), sched(sched_), nbLocRds(0), nbLocWrs(0), nbRemRds(
 					0), nbRemWrs(0), bytesLocRds(0), bytesLocWrs(0), bytesRemRds(
-					0), bytesRemWrs(0), computationTime(0), instsCsvFile(
-					constInstsCsvFile_), nocTrafficCsvFile(nocTrafficCsvFile_), nocTrafficArffFile(
-					nocTrafficArffFile_), runnablesCsvFile(runnablesCsvFile_), runnablesArffFile(
-					runnablesArffFile_), runnablesVcdFile(runnablesVcdFile_), params(
-					params_), type(
-					processingElementType(params_.getCoresFrequencyInHz(),
-							nbCyclesPerInstructions)) {
+					0), bytesRemWrs(0), computationTime(0), nbPrefetches(0), nbPrefetchHits(
+					0), nbPrefetchStalls(0), nbCombinedWrites(0), nbCombinedWritePktsSent(
+					0), nbCombinedWritePktsSaved(0), nbCacheHits(0), nbCacheMisses(0), nbCachePktsSaved(
+					0), nbCoherencePktsSent(0), nbCoherencePktsRcvd(0), nbDvfsTransitions(
+					0), dvfsTransitionTime(0), dvfsMinSlackRatio(1.0), dvfsDeadlinesMissed(
+					0), instsCsvFile(
+					constInstsCsvFile_), sinks(sinks_), waves(
+					waves_), params(
+					params_), type(type_) {
 
 		// Inits SystemC processes
 		SC_THREAD(pktReceiver_method);
 		sensitive << pe_inputs.data_written();
 		dont_initialize();
 		SC_THREAD(runnableExecuter_thread);
+		if (params.getWriteCombiningWindow() > 0) {
+			SC_THREAD(writeCombiningFlusher_thread);
+		}
 
-		// Inits the generator for deviation instructions
+		// Runnables lists are reused for the whole simulation, avoid
+		// growing them one runnable at a time
+		readyRunnables.reserve(RUNNABLES_LISTS_INITIAL_CAPACITY);
+		runnablesBlockedOnRemoteRead.reserve(RUNNABLES_LISTS_INITIAL_CAPACITY);
+
+		// Creates the label cache if required
+		if (params.getLabelCacheSize() > 0) {
+			cache = new labelCache(params.getLabelCacheSize(),
+					params.getLabelCacheWays());
+		}
+
+		// Inits the generator for deviation instructions, each PE
+		// gets its own stream
 		int seed;
 		if (params.getRandomNonDet()) {
 			seed = time(NULL);
 		} else {
 			seed = 1242;
 		}
-		gen = std::mt19937(seed);
+		sampler = new deviationSampler(
+				seed ^ std::hash<std::string>()(std::string(name)));
 	}
 
 	inline ~processingElement() {
+		delete cache;
+		delete sampler;
+	}
+
+	inline const processingElementType& getType() const {
+		return type;
+	}
+
+	void setFrequencyInHz(unsigned long int frequencyInHz,
+			unsigned long int transitionInNano);
+	void initFrequencyInHz(unsigned long int frequencyInHz);
+
+	// Write combining buffer drain at the end of the simulation
+	void drainCombinedWrites();
+	inline bool hasCombinedWrites() const {
+		return !writeCombiningBuffer.empty();
 	}
 
+	// Functional model used to fast-forward the hyperperiods that are
+	// not sampled (see hyperperiodSampler)
+	void fastForward(const vector<dcRunnableCall *> &runnables,
+			unsigned long int nbTimes);
+
+	// Checkpointing, runnable calls are saved as their index
+	// in the application runnables
+	void saveState(ostream &os,
+			const map<dcRunnableCall *, unsigned int> &runnableIndexes);
+	void restoreState(istream &is, const vector<dcRunnableCall *> &runnables,
+			runnableInstancePool &pool);
+
 	// Type definitions for managing runnables preemption
 	typedef pair<unsigned int, dcRunnableInstance*> runnableExecStatus; // instruction index, runnable
 	typedef pair<int, runnableExecStatus> runnableExecElement; // prio, instruction index, runnable
 
 	// Type definitions for managing runnables blocked on read
-	typedef pair<int, runnableExecStatus> blockedRunnableExecElement; // read request id, instruction index, runnable
+	typedef pair<int64_t, runnableExecStatus> blockedRunnableExecElement; // read request id, instruction index, runnable
 	typedef pair<pair<int, int>, int> responsePackets; // sender, nb of packets rcvd
 	typedef pair<responsePackets, pair<int, blockedRunnableExecElement> > runnableBlockedOnRemoteRead; // sender, nb of packets rcvd, preemption element, read request id, instruction index, runnable
 
@@ -141,20 +220,56 @@ private:
 	void pktReceiver_method();
 	//pktSender_thread();
 	void runnableExecuter_thread();
+	void writeCombiningFlusher_thread();
 
 	// Functions to execute runnable items
 	void executeInstructionsConstant(dcInstruction *inst,
 			dcRunnableInstance *run, int instructionId);
 	void executeInstructionsDeviation(dcInstruction *inst,
 			dcRunnableInstance *run, int instructionId);
+	unsigned long int sampleDeviation(dcInstruction *inst);
+	void waitInstruction(double timeInNano);
+	void countExecutedInstructions(dcRunnableCall *run, int instructionId,
+			unsigned long int nbInstructions);
+	void countLabelAccess(dcRemoteAccessInstruction *rinst);
+	inline double getExecutionTimeInNano(unsigned long int nbInstructions) {
+		return 1E9 * nbInstructions * type.getNbCyclesPerInstructions()
+				/ type.getFrequencyInHz();
+	}
 	void executeRemoteLabelWrite(dcRemoteAccessInstruction *rinst,
-			dcRunnableInstance *run, int writeRequestId, int x, int y);
+			dcRunnableInstance *run, int x, int y);
+	void executeCombinedLabelWrite(dcRemoteAccessInstruction *rinst,
+			dcRunnableInstance *run, int x, int y);
 	void executeRemoteLabelRead(dcRemoteAccessInstruction *rinst,
 			dcRunnableInstance *run, int x, int y, int instructionId);
+	bool executePrefetchedLabelRead(dcRemoteAccessInstruction *rinst,
+			dcRunnableInstance *run, int x, int y, int instructionId);
 
 	// Internal functions
 	void addReadyRunnable(runnableExecElement runnableExecElem);
+	int getSchedulingPriority(dcRunnableInstance *run);
 	void removeReadyRunnable(dcRunnableInstance *runnable);
+	std::pair<int, int> getLabelLocation(dcRemoteAccessInstruction *rinst);
+	Packet createReadRequest(dcRemoteAccessInstruction *rinst,
+			dcRunnableInstance *run, int x, int y);
+	void issueLabelPrefetches(dcRunnableInstance *run,
+			unsigned int instructionId);
+	void logSuspendedOnRequest();
+	void sendWritePackets(int x, int y, unsigned int priority,
+			unsigned long int nbBytes);
+	void flushCombinedWrites(int x, int y);
+	bool executeCachedLabelRead(dcRemoteAccessInstruction *rinst,
+			dcRunnableInstance *run, int instructionId);
+	void dropLabelPrefetch(
+			vector<runnableBlockedOnRemoteRead>::iterator prefetch);
+	void fillLabelCache(const runnableBlockedOnRemoteRead &completedRead);
+	int getReadLabelId(const runnableBlockedOnRemoteRead &read);
+	bool isLabelReadPending(int labelId, int64_t exceptReadRequestId);
+	void releaseLabelSharer(int labelId, int64_t readRequestId);
+	void markStaleLabelFills(int labelId);
+	void sendCoherencePackets(dcLabel *label, unsigned int priority);
+	void addLabelSharer(int labelId);
+	void removeLabelSharer(int labelId, std::pair<int, int> sharer);
 
 	typedef struct pktQElement {
 		int priority;
@@ -167,13 +282,13 @@ private:
 		//   - A write request
 		bool write; // if true, the packet belongs to a write else it belongs to a read
 		bool readResponse; // for packets belonging to read, this boolean says if it's the request or the response
-		int readRequestId; // this field is used to correlate read requests with read responses
+		int64_t readRequestId; // this field is used to correlate read requests with read responses
 
 		int requestedSize;
 		int writeSize;
 		int write_rq_ID; // Different ID for each packet of same write instruction
 		int write_rq_size;
-		int write_request_ID; //same ID for whole write instruction
+		int64_t write_request_ID; //same ID for whole write instruction
 	} pktQElement;
 
 	// Used by the core to notify the "router" (i.e. packetSender SC_THREAD)
@@ -181,30 +296,84 @@ private:
 
 	// Output files
 	FILE *instsCsvFile;
-	ofstream *nocTrafficCsvFile;
-	ofstream *nocTrafficArffFile;
-	ofstream *runnablesCsvFile;
-	ofstream *runnablesArffFile;
-	ofstream *runnablesVcdFile;
+	outputSinks *sinks;
+	waveformWriter *waves; // NULL if waveforms are disabled
 
 	// Simulation parameters
 	dcSimuParams params;
 
 	// Random number generator for deviation instructions
-	std::mt19937 gen;
+	deviationSampler *sampler = NULL;
 
 	// Stuff for handling remote write requests
 	typedef pair<pair<int, int>, pair<int, int> > writeRequest_wait_element;
-	typedef pair<int, pair<pair<unsigned int, unsigned int>, pair<int, int> > > writeRequests_in_process;
+	typedef pair<int64_t, pair<pair<unsigned int, unsigned int>, pair<int, int> > > writeRequests_in_process;
 	vector<responsePackets> waitingResponse;
 	vector<writeRequests_in_process> writeRequests;
 
+	// Sequence numbers of the packets, read requests and write requests
+	// created by this PE (see Packet::make_id)
+	uint64_t nextPktSeq = 0;
+	uint64_t nextReadRequestSeq = 0;
+	uint64_t nextWriteRequestSeq = 0;
+	inline unsigned int getPeIndex() {
+		return x_PE * params.getCols() + y_PE;
+	}
+	inline uint64_t newPacketId() {
+		return Packet::make_id(getPeIndex(), nextPktSeq++);
+	}
+	inline int64_t newReadRequestId() {
+		return Packet::make_id(getPeIndex(), nextReadRequestSeq++);
+	}
+	inline int64_t newWriteRequestId() {
+		return Packet::make_id(getPeIndex(), nextWriteRequestSeq++);
+	}
+
+	// Write combining buffer: one entry per destination PE, opened by the
+	// first write to that PE and sent when the combining window is over.
+	// Entries are kept in opening order so the first one expires first.
+	typedef struct combinedWrite {
+		std::pair<int, int> destination;
+		unsigned long int openingTimeInNano;
+		unsigned long int nbBytes;
+		unsigned int priority;
+		unsigned int nbUncombinedPkts; // packets the writes would have used without combining
+		vector<dcLabel *> labels; // coherence packets are sent with the entry
+	} combinedWrite;
+	vector<combinedWrite> writeCombiningBuffer;
+	sc_event writeCombining_event;
+	bool writeCombiningDrained = false;
+
 	// Management of the execution of runnables on this PE
 	vector<runnableExecElement> readyRunnables;
 	vector<runnableBlockedOnRemoteRead> runnablesBlockedOnRemoteRead;
 
+	// Remote reads issued ahead of use (at most params.getNbMshrs()).
+	// Entries use the same layout as runnablesBlockedOnRemoteRead and
+	// are moved there if the runnable reaches the read before all the
+	// response packets have been received.
+	vector<runnableBlockedOnRemoteRead> labelPrefetches;
+	map<dcRunnableInstance *, unsigned int> prefetchCursors; // next instruction index to examine
+	map<int64_t, int> droppedPrefetches; // read request id, response packets still expected
+
+	// Cache of remote labels, NULL if label caching is disabled. A PE
+	// is registered as a sharer when it sends a read request, so that
+	// the reads overtaken by a coherence packet do not fill the cache.
+	labelCache *cache = NULL;
+	std::set<int64_t> staleLabelFills; // read request ids
+
 	// PE's type
 	processingElementType type;
+
+	// End of the last frequency transition, no instruction starts before
+	unsigned long int dvfsTransitionEndInNano = 0;
+
+	// End of the instruction being executed, saved in checkpoints as
+	// the time left to the runnable, which waits it once restored
+	dcRunnableInstance *executingRunnable = NULL;
+	unsigned long int instructionEndInPico = 0;
+	dcRunnableInstance *resumedRunnable = NULL;
+	unsigned long int resumedRemainingInPico = 0;
 };
 
 }
@@ -11,9 +11,11 @@ namespace dreamcloud {
 namespace platform_sclib {
 
 processingElementType::processingElementType(unsigned long int frequencyInHz_,
-		unsigned long int nbCyclesPerInstructions_) :
+		unsigned long int nbCyclesPerInstructions_, std::string name_,
+		unsigned int clockDomain_) :
 		frequencyInHz(frequencyInHz_), nbCyclesPerInstructions(
-				nbCyclesPerInstructions_) {
+				nbCyclesPerInstructions_), name(name_), clockDomain(
+				clockDomain_) {
 }
 
 processingElementType::~processingElementType() {
@@ -28,6 +30,14 @@ unsigned long processingElementType::getNbCyclesPerInstructions() const {
 	return nbCyclesPerInstructions;
 }
 
+std::string processingElementType::getName() const {
+	return name;
+}
+
+unsigned int processingElementType::getClockDomain() const {
+	return clockDomain;
+}
+
 void processingElementType::setFrequencyInHz(unsigned long int frequencyInHz) {
 	this->frequencyInHz = frequencyInHz;
 }
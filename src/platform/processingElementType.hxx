@@ -8,6 +8,8 @@
 #ifndef SRC_PLATFORM_SRC_SRC_CXX_MODULES_DREAMCLOUD_PLATFORM_SCLIB_PROCESSINGELEMENTTYPE_HXX_
 #define SRC_PLATFORM_SRC_SRC_CXX_MODULES_DREAMCLOUD_PLATFORM_SCLIB_PROCESSINGELEMENTTYPE_HXX_
 
+#include <string>
+
 namespace dreamcloud {
 namespace platform_sclib {
 
@@ -15,10 +17,13 @@ class processingElementType {
 
 public:
 	processingElementType(unsigned long int frequencyInHz,
-			unsigned long int nbCyclesPerInstructions);
+			unsigned long int nbCyclesPerInstructions, std::string name = "",
+			unsigned int clockDomain = 0);
 	virtual ~processingElementType();
 	unsigned long getFrequencyInHz() const;
 	unsigned long getNbCyclesPerInstructions() const;
+	std::string getName() const;
+	unsigned int getClockDomain() const;
 	void setFrequencyInHz(unsigned long frequencyInHz);
 
 private:
@@ -30,6 +35,12 @@ private:
 	// Amalthea model. We use the invert here to be aligned with UoY IA.
 	unsigned long int frequencyInHz;
 	unsigned long int nbCyclesPerInstructions;
+
+	// Name of the AMALTHEA core type (or of the platform file entry)
+	std::string name;
+
+	// PEs of the same clock domain always run at the same frequency
+	unsigned int clockDomain;
 };
 
 }
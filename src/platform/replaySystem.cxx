@@ -0,0 +1,353 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//                           DREAMCLOUD PROJECT                               //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////
+//    INCLUDES    //
+////////////////////
+#include "replaySystem.hxx"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace dreamcloud {
+namespace platform_sclib {
+
+int replaySystem::bufferSize = 0;
+
+replayState::replayState(const vector<tracedPacket> *trace_,
+		unsigned int dimension, bool closedLoop_) :
+		trace(trace_), closedLoop(closedLoop_) {
+	replayedInjection.resize(trace->size(), -1);
+	replayedDelivery.resize(trace->size(), -1);
+	lost.resize(trace->size(), false);
+	sourcePackets.resize(dimension);
+	nextPackets.resize(dimension, 0);
+	for (size_t i = 0; i < trace->size(); i++) {
+		packetIndexes[(*trace)[i].id] = i;
+		sourcePackets[(*trace)[i].source].push_back(i);
+	}
+}
+
+const vector<tracedPacket>& replayState::getTrace() const {
+	return *trace;
+}
+
+double replayState::getReadyTime(unsigned int source) const {
+	size_t next = nextPackets[source];
+	const tracedPacket &p = (*trace)[sourcePackets[source][next]];
+	if (!closedLoop) {
+		return p.recordedInjection;
+	}
+	double ready = p.recordedInjection;
+	if (next > 0) {
+		size_t previous = sourcePackets[source][next - 1];
+		ready = replayedInjection[previous] + p.recordedInjection
+				- (*trace)[previous].recordedInjection;
+	}
+	if (p.parent >= 0) {
+		if (replayedDelivery[p.parent] >= 0) {
+			ready = std::max(ready,
+					replayedDelivery[p.parent]
+							+ std::max(0.0,
+									p.recordedInjection
+											- (*trace)[p.parent].recordedDelivery));
+		} else if (!lost[p.parent]) {
+			return -1;
+		}
+	}
+	return ready;
+}
+
+size_t replayState::inject(unsigned int source, double timeInNano) {
+	size_t packet = sourcePackets[source][nextPackets[source]++];
+	replayedInjection[packet] = timeInNano;
+	return packet;
+}
+
+bool replayState::deliver(uint64_t id, double timeInNano) {
+	std::unordered_map<uint64_t, size_t>::const_iterator packet =
+			packetIndexes.find(id);
+	if (packet == packetIndexes.end() || replayedDelivery[packet->second] >= 0
+			|| lost[packet->second]) {
+		return false;
+	}
+	replayedDelivery[packet->second] = timeInNano;
+	return true;
+}
+
+unsigned long int replayState::loseInFlight() {
+	unsigned long int nbLost = 0;
+	for (size_t i = 0; i < trace->size(); i++) {
+		if (replayedInjection[i] >= 0 && replayedDelivery[i] < 0 && !lost[i]) {
+			lost[i] = true;
+			nbLost++;
+		}
+	}
+	return nbLost;
+}
+
+replaySummary replayState::report(dcSimuParams &params, clock_t start) const {
+	replaySummary summary = replaySummary();
+	double sumLatency = 0;
+	double sumRecordedLatency = 0;
+	double maxLatency = 0;
+	double sumShift = 0;
+	double lastRecordedDelivery = 0;
+	for (size_t i = 0; i < trace->size(); i++) {
+		lastRecordedDelivery = std::max(lastRecordedDelivery,
+				(*trace)[i].recordedDelivery);
+		if (replayedDelivery[i] < 0) {
+			continue;
+		}
+		double latency = replayedDelivery[i] - replayedInjection[i];
+		sumLatency += latency;
+		sumRecordedLatency += (*trace)[i].recordedDelivery
+				- (*trace)[i].recordedInjection;
+		maxLatency = std::max(maxLatency, latency);
+		sumShift += replayedInjection[i] - (*trace)[i].recordedInjection;
+		summary.lastDeliveryInNano = std::max(summary.lastDeliveryInNano,
+				replayedDelivery[i]);
+		summary.nbDelivered++;
+	}
+	unsigned long int nbDelivered = summary.nbDelivered;
+	summary.nbPackets = trace->size();
+	summary.averageLatencyInNano =
+			nbDelivered > 0 ? sumLatency / nbDelivered : 0;
+	summary.simulationTimeInSec = (double) (std::clock() - start)
+			/ CLOCKS_PER_SEC;
+
+	cout << endl << " ##Packet trace replay##" << endl;
+	cout << "    Packet trace                                  : "
+			<< params.getReplayFile() << endl;
+	cout << "    Timing                                        : "
+			<< (params.getClosedLoop() ? "closed loop" : "open loop") << endl;
+	cout << "    XBAR arbitration policy                       : "
+			<< params.getXbarPolicy() << endl;
+	cout << "    XBAR buffer size                              : "
+			<< params.getXbarBuffSize() << endl;
+	cout << "    Number of packets replayed                    : "
+			<< summary.nbPackets << endl;
+	cout << "    Number of packets lost by the XBAR            : "
+			<< summary.nbPackets - summary.nbDelivered << endl;
+	cout << "    Average packet latency (recorded)             : "
+			<< (nbDelivered > 0 ? sumRecordedLatency / nbDelivered : 0)
+			<< " ns" << endl;
+	cout << "    Average packet latency (replayed)             : "
+			<< summary.averageLatencyInNano << " ns" << endl;
+	cout << "    Max packet latency (replayed)                 : " << maxLatency
+			<< " ns" << endl;
+	if (params.getClosedLoop()) {
+		cout << "    Average injection shift                       : "
+				<< (nbDelivered > 0 ? sumShift / nbDelivered : 0) << " ns"
+				<< endl;
+	}
+	cout << "    Last delivery (recorded)                      : "
+			<< lastRecordedDelivery << " ns" << endl;
+	cout << "    Last delivery (replayed)                      : "
+			<< summary.lastDeliveryInNano << " ns" << endl;
+	cout << "    Simulation time                               : "
+			<< summary.simulationTimeInSec << " s" << endl;
+	return summary;
+}
+
+replaySystem::replaySystem(sc_module_name name, dcSimuParams params_,
+		const vector<tracedPacket> *trace) :
+		sc_module(name), params(params_), nbInjected(0), nbDelivered(0), nbLost(
+				0), lastActivityInNano(0), sig_inp("xbInput"), sig_out(
+				"xbOutput"), summary(replaySummary()) {
+
+	if (trace == NULL) {
+		loadedTrace = loadTrace(params.getReplayFile(), params.getRows(),
+				params.getCols());
+		trace = &loadedTrace;
+	}
+	state = new replayState(trace, params.getDimension(),
+			params.getClosedLoop());
+
+	bufferSize = params.getXbarBuffSize();
+	sig_inp.init(params.getDimension(), create_fifo);
+	sig_out.init(params.getDimension(), create_fifo);
+
+	// Creating the XBAR interconnect
+	xbar = new XBAR("XBAR", params_);
+	xbar->clk(clock);
+	xbar->xb_inputs(sig_out);
+	xbar->xb_outputs(sig_inp);
+
+	start = std::clock();
+	SC_CTHREAD(injector_thread, clock.pos());
+	SC_METHOD(receiver_method);
+	for (unsigned int i = 0; i < params.getDimension(); i++) {
+		sensitive << sig_inp[i].data_written_event();
+	}
+	dont_initialize();
+}
+
+vector<tracedPacket> replaySystem::loadTrace(string file, unsigned int rows,
+		unsigned int cols) {
+	ifstream f(file);
+	if (!f.is_open()) {
+		cerr << "cannot open packet trace " << file << endl;
+		exit(-1);
+	}
+	vector<tracedPacket> trace;
+	string line;
+	getline(f, line); // header
+	for (unsigned int l = 2; getline(f, line); l++) {
+		istringstream is(line);
+		vector<string> fields;
+		string field;
+		while (getline(is, field, ',')) {
+			fields.push_back(field);
+		}
+		if (fields.size() != 10) {
+			cerr << file << ":" << l << ": invalid packet" << endl;
+			exit(-1);
+		}
+		tracedPacket p;
+		p.id = std::stoull(fields[0]);
+		p.kind = fields[1] == "write" ? tracedPacket::WRITE :
+					fields[1] == "read" ?
+							tracedPacket::READ : tracedPacket::RESPONSE;
+		p.priority = std::stoul(fields[2]);
+		p.readRequestId = std::stoll(fields[3]);
+		unsigned int sourceRow = std::stoul(fields[4]);
+		unsigned int sourceCol = std::stoul(fields[5]);
+		unsigned int destinationRow = std::stoul(fields[6]);
+		unsigned int destinationCol = std::stoul(fields[7]);
+		if (sourceRow >= rows || sourceCol >= cols || destinationRow >= rows
+				|| destinationCol >= cols) {
+			cerr << file << ":" << l << ": packet outside of the " << rows
+					<< "x" << cols << " platform" << endl;
+			exit(-1);
+		}
+		p.source = sourceRow * cols + sourceCol;
+		p.destination = destinationRow * cols + destinationCol;
+		p.recordedInjection = std::stod(fields[8]);
+		p.recordedDelivery = std::stod(fields[9]);
+		p.parent = -1;
+		trace.push_back(p);
+	}
+
+	// Packets are recorded when received, replay them in injection order
+	std::stable_sort(trace.begin(), trace.end(),
+			[](const tracedPacket &left, const tracedPacket &right)
+			{
+				return left.recordedInjection < right.recordedInjection;
+			});
+	std::unordered_map<int64_t, long int> requests;
+	for (size_t i = 0; i < trace.size(); i++) {
+		if (trace[i].kind == tracedPacket::READ) {
+			requests[trace[i].readRequestId] = i;
+		} else if (trace[i].kind == tracedPacket::RESPONSE) {
+			std::unordered_map<int64_t, long int>::iterator request =
+					requests.find(trace[i].readRequestId);
+			if (request != requests.end()
+					&& trace[request->second].destination == trace[i].source) {
+				trace[i].parent = request->second;
+			}
+		}
+	}
+	return trace;
+}
+
+const replaySummary& replaySystem::getSummary() const {
+	return summary;
+}
+
+void replaySystem::injector_thread() {
+	const vector<tracedPacket> &trace = state->getTrace();
+	double period = params.getCoresPeriodInNano();
+	while (true) {
+		double now = sc_time_stamp().value() / 1E3;
+		double nextReady = -1;
+		for (unsigned int s = 0; s < params.getDimension(); s++) {
+			if (state->isDone(s)) {
+				continue;
+			}
+			double ready = state->getReadyTime(s);
+			if (ready >= 0 && ready <= now && sig_out[s].num_free() > 0) {
+				const tracedPacket &p = trace[state->inject(s, now)];
+				Packet pck;
+				pck.set_id(p.id);
+				pck.set_priority(p.priority);
+				pck.set_source(
+						make_pair(p.source / params.getCols(),
+								p.source % params.getCols()));
+				pck.set_destination(
+						make_pair(p.destination / params.getCols(),
+								p.destination % params.getCols()));
+				pck.set_rd_wr(p.kind == tracedPacket::WRITE);
+				pck.set_req_resp(p.kind == tracedPacket::RESPONSE);
+				pck.set_requestedSize(0);
+				pck.set_write_rq_ID(0);
+				pck.set_write_rq_size(0);
+				pck.set_write_request_ID(-1);
+				pck.set_injection_time();
+				pck.set_read_request_id(p.readRequestId);
+				sig_out[s].nb_write(pck);
+				lastActivityInNano = now;
+				nbInjected++;
+				if (state->isDone(s)) {
+					continue;
+				}
+				ready = state->getReadyTime(s);
+			}
+			if (ready >= 0 && (nextReady < 0 || ready < nextReady)) {
+				nextReady = ready;
+			}
+		}
+
+		// Packets in flight for long without any activity were dropped
+		if (nbDelivered + nbLost < nbInjected
+				&& now - lastActivityInNano > REPLAY_IDLE_CYCLES * period) {
+			nbLost += state->loseInFlight();
+			lastActivityInNano = now;
+		}
+		if (nbInjected == trace.size() && nbDelivered + nbLost == nbInjected) {
+			summary = state->report(params, start);
+			sc_stop();
+			return;
+		}
+
+		// Skip the cycles without traffic up to the next injection
+		if (nbDelivered + nbLost == nbInjected && nextReady > now + period) {
+			// Long idle gaps may not fit in an int number of cycles
+			int64_t idleCycles = (int64_t) std::floor(
+					(nextReady - now) / period);
+			while (idleCycles > INT_MAX) {
+				wait(INT_MAX);
+				idleCycles -= INT_MAX;
+			}
+			wait((int) idleCycles);
+		} else {
+			wait();
+		}
+	}
+}
+
+void replaySystem::receiver_method() {
+	Packet pck;
+	for (unsigned int i = 0; i < params.getDimension(); i++) {
+		while (sig_inp[i].nb_read(pck)) {
+			if (state->deliver(pck.get_id(), pck.get_delivery_time())) {
+				lastActivityInNano = sc_time_stamp().value() / 1E3;
+				nbDelivered++;
+			}
+		}
+	}
+}
+
+}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  END OF FILE.                                                              //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
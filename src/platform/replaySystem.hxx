@@ -0,0 +1,167 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//                           DREAMCLOUD PROJECT                               //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DREAMCLOUD__PLATFORM_SCLIB__REPLAYSYSTEM_HXX
+#define DREAMCLOUD__PLATFORM_SCLIB__REPLAYSYSTEM_HXX
+
+////////////////////
+//    INCLUDES    //
+////////////////////
+#include <systemc.h>
+#include <ctime>
+#include <unordered_map>
+#include "dcSimuParams.hxx"
+#include "xbar/xbar.hxx"
+#include "xbar/lib/xbar_sc_fifo.h"
+
+namespace dreamcloud {
+namespace platform_sclib {
+
+////////////////////
+//      USING     //
+////////////////////
+using dreamcloud::platform_sclib::noc_ppa::Packet;
+using dreamcloud::platform_sclib::xbar::XBAR;
+
+// Packet of OUTPUT_Packet_Trace.csv, times in ns
+typedef struct tracedPacket {
+	enum Kind {
+		WRITE, READ, RESPONSE
+	} kind;
+	uint64_t id;
+	unsigned int priority;
+	int64_t readRequestId;
+	unsigned int source; // PE index
+	unsigned int destination;
+	double recordedInjection;
+	double recordedDelivery;
+	long int parent; // read request of a response, -1 if not traced
+} tracedPacket;
+
+// Main results of a replay, merged in the table of a parameter sweep
+typedef struct replaySummary {
+	unsigned long int nbPackets;
+	unsigned long int nbDelivered;
+	double averageLatencyInNano;
+	double lastDeliveryInNano;
+	double simulationTimeInSec;
+} replaySummary;
+
+// Cycles without injection nor delivery after which the packets in
+// flight are considered lost by the XBAR
+const unsigned long int REPLAY_IDLE_CYCLES = 10000;
+
+/**
+ * Progress of a replay: packets of each PE in injection order, next
+ * one to inject, replayed injection and delivery times. It is shared
+ * by the SystemC replay and the parallel one so that both apply the
+ * same timing rules. A PE only updates the injections of its packets
+ * and the deliveries of the packets sent to it.
+ */
+class replayState {
+
+public:
+	replayState(const vector<tracedPacket> *trace_, unsigned int dimension,
+			bool closedLoop_);
+
+	const vector<tracedPacket>& getTrace() const;
+
+	inline bool isDone(unsigned int source) const {
+		return nextPackets[source] == sourcePackets[source].size();
+	}
+
+	// Time from which the next packet of the PE can be injected, -1
+	// while it waits for the delivery of its request
+	double getReadyTime(unsigned int source) const;
+
+	// Inject the next packet of the PE, return its index in the trace
+	size_t inject(unsigned int source, double timeInNano);
+
+	// Return false for unknown, already delivered or lost packets
+	bool deliver(uint64_t id, double timeInNano);
+
+	// Consider the packets in flight lost, return their number
+	unsigned long int loseInFlight();
+
+	// Print the report of the replay and return its summary
+	replaySummary report(dcSimuParams &params, clock_t start) const;
+
+private:
+	const vector<tracedPacket> *trace;
+	bool closedLoop;
+	vector<double> replayedInjection;
+	vector<double> replayedDelivery;
+	std::unordered_map<uint64_t, size_t> packetIndexes;
+	vector<vector<size_t> > sourcePackets;
+	vector<size_t> nextPackets;
+
+	// Packets dropped by the XBAR, their responses don't wait for them
+	vector<bool> lost;
+};
+
+/**
+ * Replay of a packet trace recorded by the packet_trace output through
+ * the XBAR alone, to compare policies and buffer sizes on the traffic
+ * of an application without simulating it again. Each PE injects its
+ * packets in their recorded order, one per cycle at most, blocking
+ * while its XBAR input buffer is full.
+ *
+ * In open loop, packets are injected at their recorded time. With
+ * -closedLoop, the recorded gaps are kept instead: a packet follows the
+ * previous packet of its PE by the recorded gap, and a read response
+ * follows the replayed delivery of its request by the recorded gap, so
+ * that a slower interconnect delays the traffic depending on it.
+ */
+class replaySystem: sc_module {
+
+public:
+	sc_in<bool> clock;
+
+	SC_HAS_PROCESS(replaySystem);
+	replaySystem(sc_module_name name, dcSimuParams params_,
+			const vector<tracedPacket> *trace_ = NULL);
+
+	// Read a trace, sorted by injection time, exit on invalid traces
+	static vector<tracedPacket> loadTrace(string file, unsigned int rows,
+			unsigned int cols);
+
+	const replaySummary& getSummary() const;
+
+private:
+	void injector_thread();
+	void receiver_method();
+
+	dcSimuParams params;
+	vector<tracedPacket> loadedTrace;
+	replayState *state;
+	unsigned long int nbInjected;
+	unsigned long int nbDelivered;
+	unsigned long int nbLost;
+	double lastActivityInNano;
+
+	sc_vector<xb_sc_fifo<Packet> > sig_inp;
+	sc_vector<xb_sc_fifo<Packet> > sig_out;
+	XBAR *xbar;
+	clock_t start;
+	replaySummary summary;
+
+	static int bufferSize;
+	static xb_sc_fifo<Packet>*
+	create_fifo(const char* nm, size_t) {
+		return new xb_sc_fifo<Packet>(nm, bufferSize);
+	}
+};
+
+}
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  END OF FILE.                                                              //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
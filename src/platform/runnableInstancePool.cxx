@@ -0,0 +1,66 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//                           DREAMCLOUD PROJECT                               //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////
+//    INCLUDES    //
+////////////////////
+#include "runnableInstancePool.hxx"
+#include <new>
+
+namespace dreamcloud {
+namespace platform_sclib {
+
+runnableInstancePool::runnableInstancePool(unsigned int slabSize_) :
+		slabSize(slabSize_ > 0 ? slabSize_ : 1) {
+	addSlab();
+}
+
+runnableInstancePool::~runnableInstancePool() {
+	// Instances still alive at the end of the simulation are not
+	// destroyed, as they were not deleted before the pool either
+	for (vector<char *>::iterator it = slabs.begin(); it != slabs.end();
+			++it) {
+		::operator delete(*it);
+	}
+}
+
+dcRunnableInstance *runnableInstancePool::create(dcRunnableCall *runCall) {
+	if (freeList.empty()) {
+		addSlab();
+	}
+	void *storage = freeList.back();
+	freeList.pop_back();
+	return new (storage) dcRunnableInstance(runCall);
+}
+
+void runnableInstancePool::release(dcRunnableInstance *instance) {
+	instance->~dcRunnableInstance();
+	freeList.push_back(instance);
+}
+
+unsigned long int runnableInstancePool::getNbSlabs() const {
+	return slabs.size();
+}
+
+void runnableInstancePool::addSlab() {
+	char *slab = static_cast<char*>(::operator new(
+			slabSize * sizeof(dcRunnableInstance)));
+	slabs.push_back(slab);
+	freeList.reserve(slabs.size() * slabSize);
+	// Push in reverse order so that the slab is used from its start
+	for (unsigned int i = slabSize; i > 0; i--) {
+		freeList.push_back(slab + (i - 1) * sizeof(dcRunnableInstance));
+	}
+}
+
+}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  END OF FILE.                                                              //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,63 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//                           DREAMCLOUD PROJECT                               //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DREAMCLOUD__PLATFORM_SCLIB__RUNNABLEINSTANCEPOOL_HXX
+#define DREAMCLOUD__PLATFORM_SCLIB__RUNNABLEINSTANCEPOOL_HXX
+
+////////////////////
+//    INCLUDES    //
+////////////////////
+#include <vector>
+#include "commons/parser/dcRunnableInstance.h"
+
+namespace dreamcloud {
+namespace platform_sclib {
+
+////////////////////
+//      USING     //
+////////////////////
+using std::vector;
+using namespace DCApplication;
+
+/**
+ * Pool of runnable instances. Instances are constructed in slabs of
+ * raw storage allocated once and their storage is put back in a free
+ * list when they are released, so releasing and completing runnables
+ * doesn't allocate from the heap once the pool has grown to the
+ * maximum number of live instances.
+ */
+class runnableInstancePool {
+
+public:
+	runnableInstancePool(unsigned int slabSize = 1024);
+	~runnableInstancePool();
+
+	dcRunnableInstance *create(dcRunnableCall *runCall);
+	void release(dcRunnableInstance *instance);
+
+	unsigned long int getNbSlabs() const;
+
+private:
+	runnableInstancePool(const runnableInstancePool &);
+	runnableInstancePool &operator=(const runnableInstancePool &);
+
+	void addSlab();
+
+	unsigned int slabSize;
+	vector<char *> slabs;
+	vector<void *> freeList;
+};
+
+}
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  END OF FILE.                                                              //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,127 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//                           DREAMCLOUD PROJECT                               //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////
+//    INCLUDES    //
+////////////////////
+#include "simulationProfiler.hxx"
+#include <iomanip>
+
+namespace dreamcloud {
+namespace platform_sclib {
+
+////////////////////
+//      USING     //
+////////////////////
+using std::endl;
+
+const char *MODULE_NAMES[simulationProfiler::NB_MODULES] = { "mapper",
+		"runnable releasers", "mode switcher", "DVFS governor",
+		"PE executers", "PE packet receivers", "PE write combiners", "XBAR" };
+
+volatile sig_atomic_t simulationProfiler::snapshotRequested = 0;
+
+simulationProfiler::simulationProfiler() :
+		startTime(clock::now()), lastProgressTime(startTime), lastProgressInNano(
+				0), lastProgressPackets(0), lastProgressReleases(0), nbReleases(
+				0), nbPackets(0) {
+	for (unsigned int i = 0; i < NB_MODULES; i++) {
+		activations[i] = 0;
+	}
+}
+
+void simulationProfiler::setActivations(Module module,
+		unsigned long int nbActivations) {
+	activations[module] = nbActivations;
+}
+
+void simulationProfiler::setPackets(unsigned long int nbPackets_) {
+	nbPackets = nbPackets_;
+}
+
+double simulationProfiler::getSeconds(clock::time_point from,
+		clock::time_point to) {
+	return std::chrono::duration<double>(to - from).count();
+}
+
+double simulationProfiler::getSecondsSinceProgress() const {
+	return getSeconds(lastProgressTime, clock::now());
+}
+
+void simulationProfiler::printProgress(ostream &os,
+		unsigned long int nowInNano) {
+	clock::time_point now = clock::now();
+	double seconds = getSeconds(lastProgressTime, now);
+	if (seconds <= 0) {
+		return;
+	}
+	os << "[progress] " << std::fixed << std::setprecision(1)
+			<< getSeconds(startTime, now) << " s: " << nowInNano
+			<< " ns simulated, "
+			<< (nowInNano - lastProgressInNano) / seconds << " ns/s, "
+			<< (nbPackets - lastProgressPackets) / seconds << " packets/s, "
+			<< (nbReleases - lastProgressReleases) / seconds << " releases/s"
+			<< std::defaultfloat << endl;
+	lastProgressTime = now;
+	lastProgressInNano = nowInNano;
+	lastProgressPackets = nbPackets;
+	lastProgressReleases = nbReleases;
+}
+
+void simulationProfiler::printProfile(ostream &os,
+		unsigned long int nowInNano) {
+	double seconds = getSeconds(startTime, clock::now());
+	unsigned long int nbActivations = 0;
+	for (unsigned int i = 0; i < NB_MODULES; i++) {
+		nbActivations += activations[i];
+	}
+	os << " ##Simulation profile##" << endl << endl;
+	os << "    Wall clock time                               : " << seconds
+			<< " s" << endl;
+	if (seconds > 0) {
+		os << "    Simulated ns per wall second                  : "
+				<< nowInNano / seconds << endl;
+		os << "    Packets per wall second                       : "
+				<< nbPackets / seconds << endl;
+		os << "    Runnable releases per wall second             : "
+				<< nbReleases / seconds << endl;
+	}
+	os << "    Process activations                           : "
+			<< nbActivations << endl;
+	for (unsigned int i = 0; i < NB_MODULES; i++) {
+		os << "      " << std::left << std::setw(44) << MODULE_NAMES[i]
+				<< std::right << ": " << activations[i] << " ("
+				<< (nbActivations == 0 ?
+						0 : 100.0 * activations[i] / nbActivations) << " %)"
+				<< endl;
+	}
+	os << endl;
+}
+
+void simulationProfiler::snapshotHandler(int signal) {
+	snapshotRequested = 1;
+}
+
+void simulationProfiler::installSnapshotHandler() {
+	std::signal(SIGUSR1, snapshotHandler);
+}
+
+bool simulationProfiler::takeSnapshotRequest() {
+	if (!snapshotRequested) {
+		return false;
+	}
+	snapshotRequested = 0;
+	return true;
+}
+
+}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  END OF FILE.                                                              //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
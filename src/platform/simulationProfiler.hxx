@@ -0,0 +1,102 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//                           DREAMCLOUD PROJECT                               //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DREAMCLOUD__PLATFORM_SCLIB__SIMULATIONPROFILER_HXX
+#define DREAMCLOUD__PLATFORM_SCLIB__SIMULATIONPROFILER_HXX
+
+////////////////////
+//    INCLUDES    //
+////////////////////
+#include <chrono>
+#include <csignal>
+#include <iostream>
+
+namespace dreamcloud {
+namespace platform_sclib {
+
+////////////////////
+//      USING     //
+////////////////////
+using std::ostream;
+
+/**
+ * Performance counters of the simulator itself: activations of the
+ * SystemC processes grouped by module (one per resumption of the main
+ * loop of a process, one per instruction step for PE executers),
+ * runnable releases and crossbar packets, reported against wall clock
+ * time. Counting is a single increment so it is always enabled.
+ */
+class simulationProfiler {
+
+public:
+	enum Module {
+		MAPPER,
+		RELEASERS,
+		MODE_SWITCHER,
+		DVFS_GOVERNOR,
+		PE_EXECUTERS,
+		PE_RECEIVERS,
+		PE_WRITE_COMBINERS,
+		XBAR,
+		NB_MODULES
+	};
+
+	simulationProfiler();
+
+	inline void activated(Module module) {
+		activations[module]++;
+	}
+
+	inline void runnableReleased() {
+		nbReleases++;
+	}
+
+	// Counters kept by other modules, updated before reports
+	void setActivations(Module module, unsigned long int nbActivations);
+	void setPackets(unsigned long int nbPackets_);
+
+	// One line with the simulated time and the rates since the last one
+	void printProgress(ostream &os, unsigned long int nowInNano);
+
+	// Rates since the start and activations of each module
+	void printProfile(ostream &os, unsigned long int nowInNano);
+
+	double getSecondsSinceProgress() const;
+
+	// SIGUSR1 asks for a snapshot of the profile, the request is
+	// taken by the process polling it
+	static void installSnapshotHandler();
+	static bool takeSnapshotRequest();
+
+private:
+	typedef std::chrono::steady_clock clock;
+
+	static double getSeconds(clock::time_point from, clock::time_point to);
+	static void snapshotHandler(int signal);
+
+	clock::time_point startTime;
+	clock::time_point lastProgressTime;
+	unsigned long int lastProgressInNano;
+	unsigned long int lastProgressPackets;
+	unsigned long int lastProgressReleases;
+
+	unsigned long int activations[NB_MODULES];
+	unsigned long int nbReleases;
+	unsigned long int nbPackets;
+
+	static volatile sig_atomic_t snapshotRequested;
+};
+
+}
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  END OF FILE.                                                              //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,186 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//                           DREAMCLOUD PROJECT                               //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////
+//    INCLUDES    //
+////////////////////
+#include "trafficGenerator.hxx"
+#include "dcConfiguration.hxx"
+#include <algorithm>
+
+namespace dreamcloud {
+namespace platform_sclib {
+
+trafficGenerator::trafficGenerator(sc_module_name name, dcSimuParams params_,
+		unsigned int peIndex_) :
+		sc_module(name), params(params_), pattern(
+				params_.getTrafficPattern()), peIndex(peIndex_), dimension(
+				params_.getDimension()), injectionRate(0), measureStartInNano(
+				0), measureEndInNano(0), nbPackets(0), counters(
+				trafficCounters()), uniforms(peIndex_ + 1), burstOn(false), burstDestination(
+				-1) {
+	SC_CTHREAD(injector_thread, clock.pos());
+	SC_METHOD(receiver_method);
+	sensitive << pe_inputs.data_written();
+	dont_initialize();
+}
+
+void trafficGenerator::setInjectionRate(double rate) {
+	injectionRate = rate;
+	sourceQueue.clear();
+	burstOn = false;
+}
+
+void trafficGenerator::setMeasureWindow(double startInNano, double endInNano) {
+	measureStartInNano = startInNano;
+	measureEndInNano = endInNano;
+	counters = trafficCounters();
+}
+
+const trafficCounters& trafficGenerator::getCounters() const {
+	return counters;
+}
+
+unsigned long int trafficGenerator::getNbQueuedInWindow() const {
+	return std::count_if(sourceQueue.begin(), sourceQueue.end(),
+			[this](const Packet &pck)
+			{
+				return inWindow(pck.get_injection_time());
+			});
+}
+
+bool trafficGenerator::inWindow(double timeInNano) const {
+	return timeInNano >= measureStartInNano && timeInNano < measureEndInNano;
+}
+
+/**
+ * Each cycle, generate at most one packet and write the head of the
+ * source queue to the XBAR.
+ */
+void trafficGenerator::injector_thread() {
+	while (true) {
+		bool generate;
+		if (pattern == "bursty") {
+			// On/off process: bursts of TRAFFIC_MEAN_BURST_LENGTH packets
+			// on average, off periods giving the injection rate on average
+			double onToOff = 1.0 / TRAFFIC_MEAN_BURST_LENGTH;
+			double offToOn =
+					injectionRate >= 1 ?
+							1 :
+							injectionRate
+									/ (TRAFFIC_MEAN_BURST_LENGTH
+											* (1 - injectionRate));
+			if (burstOn && injectionRate < 1 && uniforms.next() < onToOff) {
+				burstOn = false;
+			} else if (!burstOn && uniforms.next() < offToOn) {
+				burstOn = true;
+				burstDestination = uniformDestination();
+			}
+			generate = burstOn;
+		} else {
+			generate = uniforms.next() < injectionRate;
+		}
+
+		int destination = generate ? nextDestination() : -1;
+		if (destination >= 0) {
+			Packet pck;
+			pck.set_id(Packet::make_id(peIndex, nbPackets++));
+			pck.set_priority(
+					1 + (unsigned int) (uniforms.next() * TRAFFIC_PRIORITY_LEVELS));
+			pck.set_source(
+					make_pair(peIndex / params.getCols(),
+							peIndex % params.getCols()));
+			pck.set_destination(
+					make_pair(destination / params.getCols(),
+							destination % params.getCols()));
+			pck.set_rd_wr(true);
+			pck.set_req_resp(false);
+			pck.set_requestedSize(0);
+			pck.set_write_rq_ID(0);
+			pck.set_write_rq_size(1);
+			pck.set_write_request_ID(-1);
+			pck.set_injection_time();
+			pck.set_read_request_id(-1);
+			sourceQueue.push_back(pck);
+			if (inWindow(pck.get_injection_time())) {
+				counters.nbInjected++;
+			}
+		}
+
+		if (!sourceQueue.empty() && pe_outputs.num_free() > 0
+				&& pe_outputs.nb_write(sourceQueue.front())) {
+			if (inWindow(sourceQueue.front().get_injection_time())) {
+				counters.nbSent++;
+			}
+			sourceQueue.pop_front();
+		}
+		wait();
+	}
+}
+
+void trafficGenerator::receiver_method() {
+	Packet pck;
+	while (pe_inputs.nb_read(pck)) {
+		if (!inWindow(pck.get_injection_time())) {
+			continue;
+		}
+		double latency = sc_time_stamp().value() / 1E3
+				- pck.get_injection_time();
+		counters.nbReceived++;
+		counters.sumLatencyInNano += latency;
+		counters.maxLatencyInNano = std::max(counters.maxLatencyInNano,
+				latency);
+	}
+}
+
+/**
+ * Destination of the next packet, -1 when the pattern maps the core
+ * to itself (no packet is generated then).
+ */
+int trafficGenerator::nextDestination() {
+	unsigned int rows = params.getRows();
+	unsigned int cols = params.getCols();
+	int destination;
+	if (pattern == "hotspot") {
+		int hotspot = (rows / 2) * cols + cols / 2;
+		destination =
+				uniforms.next() < TRAFFIC_HOTSPOT_FRACTION ?
+						hotspot : uniformDestination();
+	} else if (pattern == "transpose") {
+		unsigned int row = peIndex / cols;
+		unsigned int col = peIndex % cols;
+		destination = (col % rows) * cols + row % cols;
+	} else if (pattern == "bitcomp") {
+		if ((dimension & (dimension - 1)) == 0) {
+			destination = ~peIndex & (dimension - 1);
+		} else {
+			destination = dimension - 1 - peIndex;
+		}
+	} else if (pattern == "bursty") {
+		destination = burstDestination;
+	} else {
+		destination = uniformDestination();
+	}
+	return destination == (int) peIndex ? -1 : destination;
+}
+
+// Uniform destination among the other cores
+int trafficGenerator::uniformDestination() {
+	if (dimension < 2) {
+		return -1;
+	}
+	int destination = uniforms.next() * (dimension - 1);
+	return destination >= (int) peIndex ? destination + 1 : destination;
+}
+
+}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  END OF FILE.                                                              //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
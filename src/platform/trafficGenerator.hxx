@@ -0,0 +1,103 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//                           DREAMCLOUD PROJECT                               //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DREAMCLOUD__PLATFORM_SCLIB__TRAFFICGENERATOR_HXX
+#define DREAMCLOUD__PLATFORM_SCLIB__TRAFFICGENERATOR_HXX
+
+////////////////////
+//    INCLUDES    //
+////////////////////
+#include <systemc.h>
+#include <deque>
+#include <string>
+#include "dcSimuParams.hxx"
+#include "deviationSampler.hxx"
+#include "xbar/packet.hxx"
+#include "xbar/lib/xbar_sc_fifo_ports.h"
+
+namespace dreamcloud {
+namespace platform_sclib {
+
+////////////////////
+//      USING     //
+////////////////////
+using dreamcloud::platform_sclib::noc_ppa::Packet;
+
+// Packets counters of a generator, only packets injected in the
+// measurement window are counted
+typedef struct trafficCounters {
+	unsigned long int nbInjected; // generated in the source queue
+	unsigned long int nbSent; // written to the XBAR
+	unsigned long int nbReceived;
+	double sumLatencyInNano;
+	double maxLatencyInNano;
+} trafficCounters;
+
+/**
+ * Synthetic traffic source and sink of one core, replacing the PE in
+ * traffic mode. Each clock cycle a packet is generated with the
+ * injection rate probability (bursty traffic follows an on/off Markov
+ * process of the same mean rate) and queued in an unbounded source
+ * queue, whose head is written to the XBAR when its input buffer has
+ * room. The latency of a packet is its delivery time minus its
+ * generation time, so it includes the source queueing delay.
+ */
+class trafficGenerator: sc_module {
+
+public:
+	xb_sc_fifo_in<Packet> pe_inputs;
+	xb_sc_fifo_out<Packet> pe_outputs;
+	sc_in<bool> clock;
+
+	SC_HAS_PROCESS(trafficGenerator);
+	trafficGenerator(sc_module_name name, dcSimuParams params_,
+			unsigned int peIndex_);
+
+	// Clear the source queue and inject at the given rate from now on
+	void setInjectionRate(double rate);
+
+	// Count the packets generated in [start, end[, reset the counters
+	void setMeasureWindow(double startInNano, double endInNano);
+
+	const trafficCounters& getCounters() const;
+
+	// Packets of the measurement window still in the source queue
+	unsigned long int getNbQueuedInWindow() const;
+
+private:
+	void injector_thread();
+	void receiver_method();
+	bool inWindow(double timeInNano) const;
+	int nextDestination();
+	int uniformDestination();
+
+	dcSimuParams params;
+	string pattern;
+	unsigned int peIndex;
+	unsigned int dimension;
+	double injectionRate;
+	double measureStartInNano;
+	double measureEndInNano;
+	uint64_t nbPackets;
+	trafficCounters counters;
+	std::deque<Packet> sourceQueue;
+	uniformBatchGenerator uniforms;
+
+	// Bursty pattern state: the whole burst goes to one destination
+	bool burstOn;
+	int burstDestination;
+};
+
+}
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  END OF FILE.                                                              //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,185 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//                           DREAMCLOUD PROJECT                               //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////
+//    INCLUDES    //
+////////////////////
+#include "trafficSystem.hxx"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace dreamcloud {
+namespace platform_sclib {
+
+int trafficSystem::bufferSize = 0;
+
+// Simulated cycles between two checks of the end of the drain phase
+const unsigned long int DRAIN_POLL_CYCLES = 100;
+
+// Latency ratio to the zero-load latency beyond which the crossbar is
+// considered saturated
+const double SATURATION_LATENCY_RATIO = 2;
+
+trafficSystem::trafficSystem(sc_module_name name, dcSimuParams params_) :
+		sc_module(name), params(params_), sig_inp("xbInput"), sig_out(
+				"xbOutput"), summary(trafficSummary()) {
+
+	bufferSize = params.getXbarBuffSize();
+	sig_inp.init(params.getDimension(), create_fifo);
+	sig_out.init(params.getDimension(), create_fifo);
+
+	for (unsigned int i = 0; i < params.getDimension(); i++) {
+		ostringstream name("");
+		name << "TG(" << i / params.getCols() << "," << i % params.getCols()
+				<< ")";
+		trafficGenerator *generator = new trafficGenerator(
+				name.str().c_str(), params, i);
+		generator->clock(clock);
+		generator->pe_inputs(sig_inp.at(i));
+		generator->pe_outputs(sig_out.at(i));
+		generators.push_back(generator);
+	}
+
+	// Creating the XBAR interconnect
+	xbar = new XBAR("XBAR", params_);
+	xbar->clk(clock);
+	xbar->xb_inputs(sig_out);
+	xbar->xb_outputs(sig_inp);
+
+	start = std::clock();
+	SC_THREAD(control_thread);
+}
+
+const trafficSummary& trafficSystem::getSummary() const {
+	return summary;
+}
+
+void trafficSystem::control_thread() {
+	cout << endl << " ##Traffic characterization##" << endl;
+	cout << "    Traffic pattern                               : "
+			<< params.getTrafficPattern() << endl;
+	cout << "    XBAR arbitration policy                       : "
+			<< params.getXbarPolicy() << endl;
+	cout << "    XBAR buffer size                              : "
+			<< params.getXbarBuffSize() << endl;
+	cout << "    Measurement window                            : "
+			<< params.getTrafficWindow() << " cycles" << endl;
+
+	ofstream f(params.getOutputFolder() + "/OUTPUT_Traffic_LoadLatency.csv");
+	f << "Pattern,Policy,Buffer size,Injection rate,Offered load,"
+			"Accepted throughput,Average latency(ns),Max latency(ns),"
+			"Lost packets,Queued packets" << endl;
+	vector<double> rates = params.getInjectionRates();
+	std::sort(rates.begin(), rates.end());
+	for (vector<double>::iterator rate = rates.begin(); rate != rates.end();
+			++rate) {
+		measure(*rate, f);
+	}
+	f.close();
+
+	cout << "    Zero-load latency                             : "
+			<< summary.zeroLoadLatencyInNano << " ns" << endl;
+	cout << "    Saturation throughput                         : "
+			<< summary.saturationThroughput << " packets/cycle/core" << endl;
+	cout << "    Saturation injection rate                     : ";
+	if (summary.saturationRate > 0) {
+		cout << summary.saturationRate << " packets/cycle/core" << endl;
+	} else {
+		cout << "not reached" << endl;
+	}
+	summary.nbPackets = xbar->GetTotalPacketExchanged();
+	summary.simulationTimeInSec = (double) (std::clock() - start)
+			/ CLOCKS_PER_SEC;
+	cout << "    Number of packets exchanged through XBAR      : "
+			<< summary.nbPackets << endl;
+	cout << "    Simulation time                               : "
+			<< summary.simulationTimeInSec << " s" << endl;
+	sc_stop();
+}
+
+/**
+ * Simulate one injection rate. Packets still queued in the sources
+ * at the end of the drain timeout are reported apart from the packets
+ * the XBAR dropped on full output buffers.
+ */
+void trafficSystem::measure(double rate, ofstream &f) {
+	unsigned long int window = params.getTrafficWindow();
+	double startInNano = sc_time_stamp().value() / 1E3
+			+ (window / 10) * params.getCoresPeriodInNano();
+	double endInNano = startInNano + window * params.getCoresPeriodInNano();
+	for (vector<trafficGenerator*>::iterator it = generators.begin();
+			it != generators.end(); ++it) {
+		(*it)->setInjectionRate(rate);
+		(*it)->setMeasureWindow(startInNano, endInNano);
+	}
+	wait((window / 10 + window) * params.getCoresPeriodInNano(), SC_NS);
+
+	// Drain: the sources keep injecting but only the packets of the
+	// window are waited for, at most for another window
+	trafficCounters total;
+	unsigned long int nbQueued = 0;
+	unsigned long int lastReceived = 0;
+	for (unsigned long int drained = 0; drained <= window; drained +=
+			DRAIN_POLL_CYCLES) {
+		total = trafficCounters();
+		nbQueued = 0;
+		for (vector<trafficGenerator*>::iterator it = generators.begin();
+				it != generators.end(); ++it) {
+			const trafficCounters &counters = (*it)->getCounters();
+			total.nbInjected += counters.nbInjected;
+			total.nbSent += counters.nbSent;
+			total.nbReceived += counters.nbReceived;
+			total.sumLatencyInNano += counters.sumLatencyInNano;
+			total.maxLatencyInNano = std::max(total.maxLatencyInNano,
+					counters.maxLatencyInNano);
+			nbQueued += (*it)->getNbQueuedInWindow();
+		}
+		if (total.nbReceived == total.nbInjected
+				|| (nbQueued == 0 && drained > 0
+						&& total.nbReceived == lastReceived)) {
+			break;
+		}
+		lastReceived = total.nbReceived;
+		wait(DRAIN_POLL_CYCLES * params.getCoresPeriodInNano(), SC_NS);
+	}
+
+	double nbCoreCycles = (double) window * params.getDimension();
+	double offered = total.nbInjected / nbCoreCycles;
+	double accepted = total.nbReceived / nbCoreCycles;
+	double latency =
+			total.nbReceived > 0 ?
+					total.sumLatencyInNano / total.nbReceived : 0;
+	f << params.getTrafficPattern() << "," << params.getXbarPolicy() << ","
+			<< params.getXbarBuffSize() << "," << rate << "," << offered << ","
+			<< accepted << "," << latency << "," << total.maxLatencyInNano
+			<< "," << total.nbSent - total.nbReceived << "," << nbQueued
+			<< endl;
+	cout << "    Injection rate " << std::setw(6) << rate << " : accepted "
+			<< accepted << ", average latency " << latency << " ns" << endl;
+
+	if (summary.zeroLoadLatencyInNano == 0) {
+		summary.zeroLoadLatencyInNano = latency;
+	}
+	summary.saturationThroughput = std::max(summary.saturationThroughput,
+			accepted);
+	if (summary.saturationRate == 0 && summary.zeroLoadLatencyInNano > 0
+			&& (latency
+					> SATURATION_LATENCY_RATIO * summary.zeroLoadLatencyInNano
+					|| nbQueued > 0)) {
+		summary.saturationRate = rate;
+	}
+}
+
+}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  END OF FILE.                                                              //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
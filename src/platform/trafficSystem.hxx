@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//                           DREAMCLOUD PROJECT                               //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DREAMCLOUD__PLATFORM_SCLIB__TRAFFICSYSTEM_HXX
+#define DREAMCLOUD__PLATFORM_SCLIB__TRAFFICSYSTEM_HXX
+
+////////////////////
+//    INCLUDES    //
+////////////////////
+#include <systemc.h>
+#include <ctime>
+#include "dcSimuParams.hxx"
+#include "trafficGenerator.hxx"
+#include "xbar/xbar.hxx"
+#include "xbar/lib/xbar_sc_fifo.h"
+
+namespace dreamcloud {
+namespace platform_sclib {
+
+////////////////////
+//      USING     //
+////////////////////
+using dreamcloud::platform_sclib::xbar::XBAR;
+
+// Main results of a traffic characterization, merged in the table of
+// a parameter sweep
+typedef struct trafficSummary {
+	double saturationThroughput; // in packets per cycle per core
+	double saturationRate; // in packets per cycle per core, 0 if not reached
+	double zeroLoadLatencyInNano;
+	unsigned int nbPackets;
+	double simulationTimeInSec;
+} trafficSummary;
+
+/**
+ * Crossbar characterization with synthetic traffic: the cores are
+ * replaced by traffic generators and each injection rate is simulated
+ * in turn, with a warmup of a tenth of the measurement window, the
+ * measurement window, then a drain phase waiting for the packets of
+ * the window. The load-latency curve is written in
+ * OUTPUT_Traffic_LoadLatency.csv.
+ */
+class trafficSystem: sc_module {
+
+public:
+	sc_in<bool> clock;
+
+	SC_HAS_PROCESS(trafficSystem);
+	trafficSystem(sc_module_name name, dcSimuParams params_);
+
+	const trafficSummary& getSummary() const;
+
+private:
+	void control_thread();
+
+	// Simulate one injection rate and write its results line
+	void measure(double rate, ofstream &f);
+
+	dcSimuParams params;
+	sc_vector<xb_sc_fifo<Packet> > sig_inp;
+	sc_vector<xb_sc_fifo<Packet> > sig_out;
+	vector<trafficGenerator*> generators;
+	XBAR *xbar;
+	clock_t start;
+	trafficSummary summary;
+
+	static int bufferSize;
+	static xb_sc_fifo<Packet>*
+	create_fifo(const char* nm, size_t) {
+		return new xb_sc_fifo<Packet>(nm, bufferSize);
+	}
+};
+
+}
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  END OF FILE.                                                              //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,226 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//                           DREAMCLOUD PROJECT                               //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////
+//    INCLUDES    //
+////////////////////
+#include "waveformWriter.hxx"
+#include <algorithm>
+#include <bitset>
+#include <ctime>
+#include <limits>
+
+namespace dreamcloud {
+namespace platform_sclib {
+
+////////////////////
+//      USING     //
+////////////////////
+using std::endl;
+using std::ios;
+
+// Number of buffered changes triggering a write
+const unsigned long int WAVEFORM_FLUSH_THRESHOLD = 65536;
+
+// Names of the signals of each PE in the VCD file
+const char *WAVEFORM_SIGNAL_NAMES[] = { "ACTIVE_RUNNABLE_ID",
+		"SUSPENDED_ON_REQUEST", "PREEMPTION", "RUNNABLE_COMPLETED",
+		"DEADLINE_MISSED" };
+
+// Width of the active runnable signal
+const unsigned int WAVEFORM_ID_BITS = 12;
+
+waveformWriter::waveformWriter(string outputFolder, string format,
+		unsigned int nbPes_, unsigned int cols_,
+		unsigned long int windowStartInNano, unsigned long int windowEndInNano) :
+		binary(format == "bin"), headerWritten(false), closed(false), nbPes(
+				nbPes_), cols(cols_), windowStartInPico(
+				windowStartInNano * 1000ULL), windowEndInPico(
+				windowEndInNano > 0 ?
+						windowEndInNano * 1000ULL :
+						std::numeric_limits<uint64_t>::max()), buffers(
+				nbPes_), nbBuffered(0), activeAtWindowStart(nbPes_,
+				UNDEFINED), lastTimeInPico(0) {
+	if (binary) {
+		f.open(outputFolder + "/OUTPUT_CORE_WAVE.bin", ios::out | ios::binary);
+	} else {
+		f.open(outputFolder + "/OUTPUT_CORE_WAVE.vcd");
+	}
+}
+
+waveformWriter::~waveformWriter() {
+	if (!closed) {
+		close(lastTimeInPico);
+	}
+}
+
+void waveformWriter::record(unsigned int pe, Signal signal,
+		uint64_t timeInPico, int value) {
+	if (timeInPico < windowStartInPico) {
+		if (signal == ACTIVE_RUNNABLE) {
+			activeAtWindowStart[pe] = value;
+		}
+		return;
+	}
+	if (timeInPico >= windowEndInPico) {
+		return;
+	}
+	valueChange change = { timeInPico, pe, signal, value };
+	buffers[pe].push_back(change);
+	if (++nbBuffered >= WAVEFORM_FLUSH_THRESHOLD) {
+		flush(timeInPico);
+	}
+}
+
+void waveformWriter::close(uint64_t endTimeInPico) {
+	flush(std::numeric_limits<uint64_t>::max());
+	if (!headerWritten) {
+		writeHeader();
+	}
+	uint64_t endInPico = std::min(std::max(endTimeInPico, windowStartInPico),
+			windowEndInPico);
+	if (!binary && endInPico > lastTimeInPico) {
+		f << "#" << endInPico << endl;
+	}
+	f.close();
+	closed = true;
+}
+
+/**
+ * Write, in time order, the buffered changes older than the given time.
+ */
+void waveformWriter::flush(uint64_t beforePico) {
+	if (!headerWritten) {
+		writeHeader();
+	}
+	vector<valueChange> changes;
+	changes.reserve(nbBuffered);
+	for (vector<vector<valueChange> >::iterator buffer = buffers.begin();
+			buffer != buffers.end(); ++buffer) {
+		vector<valueChange>::iterator end = buffer->begin();
+		while (end != buffer->end() && end->timeInPico < beforePico) {
+			++end;
+		}
+		changes.insert(changes.end(), buffer->begin(), end);
+		buffer->erase(buffer->begin(), end);
+	}
+	nbBuffered -= changes.size();
+
+	// Each buffer is sorted, the stable sort keeps the PE order
+	// between changes at the same time
+	std::stable_sort(changes.begin(), changes.end(),
+			[](const valueChange &left, const valueChange &right)
+			{
+				return left.timeInPico < right.timeInPico;
+			});
+	for (vector<valueChange>::iterator it = changes.begin();
+			it != changes.end(); ++it) {
+		writeChange(*it);
+	}
+}
+
+void waveformWriter::writeHeader() {
+	headerWritten = true;
+	if (binary) {
+		uint32_t header[3] = { 1, nbPes, NB_SIGNALS };
+		f.write("DCWF", 4);
+		f.write(reinterpret_cast<const char*>(header), sizeof(header));
+		for (unsigned int pe = 0; pe < nbPes; pe++) {
+			valueChange initial = { windowStartInPico, pe, ACTIVE_RUNNABLE,
+					activeAtWindowStart[pe] };
+			writeChange(initial);
+		}
+		return;
+	}
+	time_t rawtime;
+	char buffer[80];
+	time(&rawtime);
+	strftime(buffer, 80, "%d-%m-%Y %I:%M:%S", localtime(&rawtime));
+	f << "$date " << buffer << " $end" << endl;
+	f << "$timescale 1 ps $end" << endl;
+	f << "$scope module platform $end" << endl;
+	for (unsigned int pe = 0; pe < nbPes; pe++) {
+		for (unsigned int signal = 0; signal < NB_SIGNALS; signal++) {
+			f << "$var " << (signal == ACTIVE_RUNNABLE ? "wire " : "event ")
+					<< (signal == ACTIVE_RUNNABLE ? WAVEFORM_ID_BITS : 1)
+					<< " " << getVcdId(pe, (Signal) signal) << " "
+					<< WAVEFORM_SIGNAL_NAMES[signal] << "-PE" << pe / cols
+					<< pe % cols << " $end" << endl;
+		}
+	}
+	f << "$upscope $end" << endl << "$enddefinitions $end" << endl;
+	f << "#" << windowStartInPico << endl << "$dumpvars" << endl;
+	for (unsigned int pe = 0; pe < nbPes; pe++) {
+		if (activeAtWindowStart[pe] == UNDEFINED) {
+			f << "bx " << getVcdId(pe, ACTIVE_RUNNABLE) << endl;
+		} else {
+			f << "b" << std::bitset<WAVEFORM_ID_BITS>(activeAtWindowStart[pe])
+					<< " " << getVcdId(pe, ACTIVE_RUNNABLE) << endl;
+		}
+	}
+	f << "$end" << endl;
+	lastTimeInPico = windowStartInPico;
+}
+
+void waveformWriter::writeChange(const valueChange &change) {
+	if (binary) {
+		writeVarint(change.timeInPico - lastTimeInPico);
+		writeVarint(change.pe * NB_SIGNALS + change.signal);
+		writeVarint(change.value + 1);
+		lastTimeInPico = change.timeInPico;
+		return;
+	}
+	if (change.timeInPico != lastTimeInPico) {
+		f << "#" << change.timeInPico << endl;
+		lastTimeInPico = change.timeInPico;
+	}
+	string id = getVcdId(change.pe, change.signal);
+	if (change.signal != ACTIVE_RUNNABLE) {
+		f << "1" << id << endl;
+	} else if (change.value == UNDEFINED) {
+		f << "bx " << id << endl;
+	} else {
+		f << "b" << std::bitset<WAVEFORM_ID_BITS>(change.value) << " " << id
+				<< endl;
+	}
+}
+
+void waveformWriter::writeVarint(uint64_t value) {
+	char bytes[10];
+	unsigned int nbBytes = 0;
+	do {
+		bytes[nbBytes] = value & 0x7F;
+		value >>= 7;
+		if (value != 0) {
+			bytes[nbBytes] |= 0x80;
+		}
+		nbBytes++;
+	} while (value != 0);
+	f.write(bytes, nbBytes);
+}
+
+/**
+ * Return the VCD identifier of the given signal, made of the printable
+ * characters ! to ~.
+ */
+string waveformWriter::getVcdId(unsigned int pe, Signal signal) {
+	unsigned int index = pe * NB_SIGNALS + signal;
+	string id;
+	do {
+		id += (char) ('!' + index % 94);
+		index /= 94;
+	} while (index != 0);
+	return id;
+}
+
+}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  END OF FILE.                                                              //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
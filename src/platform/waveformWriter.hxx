@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//                           DREAMCLOUD PROJECT                               //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DREAMCLOUD__PLATFORM_SCLIB__WAVEFORMWRITER_HXX
+#define DREAMCLOUD__PLATFORM_SCLIB__WAVEFORMWRITER_HXX
+
+////////////////////
+//    INCLUDES    //
+////////////////////
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <fstream>
+
+namespace dreamcloud {
+namespace platform_sclib {
+
+////////////////////
+//      USING     //
+////////////////////
+using std::string;
+using std::vector;
+using std::ofstream;
+
+/**
+ * Writer of the PE waveforms (active runnable and runnable events).
+ *
+ * Value changes are buffered per PE with integer times in ps and
+ * written in time order once enough of them are buffered. As all the
+ * PEs record changes at the current simulation time, the changes
+ * older than the last recorded one are complete and can be merged.
+ * Changes outside the capture window [start, end[ are dropped, the
+ * active runnable at the start of the window is dumped first.
+ *
+ * The waveform is either a VCD file (OUTPUT_CORE_WAVE.vcd) or a
+ * compact binary file (OUTPUT_CORE_WAVE.bin) made of:
+ *   "DCWF", uint32 version, uint32 nb PEs, uint32 nb signals per PE
+ *   then one record per change of unsigned LEB128 varints:
+ *   time delta in ps, PE index * nb signals + signal, value + 1
+ *   (0 for an undefined value, events have the value 1)
+ */
+class waveformWriter {
+
+public:
+	enum Signal {
+		ACTIVE_RUNNABLE,
+		SUSPENDED_ON_REQUEST,
+		PREEMPTION,
+		RUNNABLE_COMPLETED,
+		DEADLINE_MISSED,
+		NB_SIGNALS
+	};
+	static const int UNDEFINED = -1;
+
+	// Format is "vcd" or "bin", window bounds are in ns
+	// (end 0 means until the end of the simulation)
+	waveformWriter(string outputFolder, string format, unsigned int nbPes,
+			unsigned int cols, unsigned long int windowStartInNano,
+			unsigned long int windowEndInNano);
+	~waveformWriter();
+
+	void record(unsigned int pe, Signal signal, uint64_t timeInPico,
+			int value = 1);
+
+	// Write all the buffered changes and the final time
+	void close(uint64_t endTimeInPico);
+
+private:
+	typedef struct valueChange {
+		uint64_t timeInPico;
+		unsigned int pe;
+		Signal signal;
+		int value;
+	} valueChange;
+
+	void flush(uint64_t beforePico);
+	void writeHeader();
+	void writeChange(const valueChange &change);
+	void writeVarint(uint64_t value);
+	string getVcdId(unsigned int pe, Signal signal);
+
+	ofstream f;
+	bool binary;
+	bool headerWritten;
+	bool closed;
+	unsigned int nbPes;
+	unsigned int cols;
+	uint64_t windowStartInPico;
+	uint64_t windowEndInPico;
+	vector<vector<valueChange> > buffers; // per PE
+	unsigned long int nbBuffered;
+	vector<int> activeAtWindowStart; // per PE
+	uint64_t lastTimeInPico;
+};
+
+}
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  END OF FILE.                                                              //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
@@ -15,6 +15,7 @@
 //    INCLUDES    //
 ////////////////////
 #include <systemc.h>
+#include <stdint.h>
 #include <vector>
 #include <string>
 #include <sstream>
@@ -34,13 +35,26 @@ using std::ostringstream;
 
 class Packet {
 public:
-	inline void set_id(unsigned int id) {
+	// Kind of coherence packets exchanged between label caches
+	enum CoherenceKind {
+		NO_COHERENCE, INVALIDATE, UPDATE
+	};
+
+	// Packet, read request and write request ids are made of the index of
+	// the PE creating them in the upper bits and of a sequence number of
+	// this PE in the lower ones, so that PEs never share an id counter
+	static const unsigned int ID_SEQUENCE_BITS = 48;
+	static inline uint64_t make_id(unsigned int peIndex, uint64_t sequence) {
+		return ((uint64_t) peIndex << ID_SEQUENCE_BITS) | sequence;
+	}
+
+	inline void set_id(uint64_t id) {
 		id_ = id;
 	}
 	inline void set_priority(unsigned int prio) {
 		priority_ = prio;
 	}
-	inline void set_read_request_id(int info) {
+	inline void set_read_request_id(int64_t info) {
 		read_request_id = info;
 	}
 	inline void set_source(pair<unsigned int, unsigned int> src) {
@@ -77,14 +91,20 @@ public:
 	inline void set_write_rq_size(int write_rq_size) {
 		write_rq_size_ = write_rq_size;
 	}
-	inline void set_write_request_ID(int write_request_ID) {
+	inline void set_write_request_ID(int64_t write_request_ID) {
 		write_request_ID_ = write_request_ID;
 	}
 	inline void set_packet_size(int pkt_size) {
 		pkt_size_ = pkt_size;
 	}
+	inline void set_label_id(int label_id) {
+		label_id_ = label_id;
+	}
+	inline void set_coherence(CoherenceKind coherence) {
+		coherence_ = coherence;
+	}
 
-	inline unsigned int get_id() const {
+	inline uint64_t get_id() const {
 		return id_;
 	}
 	inline unsigned int get_delivery_time() const {
@@ -102,7 +122,7 @@ public:
 	inline unsigned int get_priority() const {
 		return priority_;
 	}
-	inline unsigned int get_read_request_id() const {
+	inline int64_t get_read_request_id() const {
 		return read_request_id;
 	}
 	inline pair<unsigned int, unsigned int> get_source() const {
@@ -129,12 +149,18 @@ public:
 	inline int get_write_rq_size() {
 		return write_rq_size_;
 	}
-	inline int get_write_request_ID() {
+	inline int64_t get_write_request_ID() {
 		return write_request_ID_;
 	}
 	inline int get_packet_size() {
 		return pkt_size_;
 	}
+	inline int get_label_id() const {
+		return label_id_;
+	}
+	inline CoherenceKind get_coherence() const {
+		return coherence_;
+	}
 
 	string to_str() const {
 		ostringstream stream("");
@@ -144,7 +170,8 @@ public:
 
 	inline bool operator==(const Packet& p) const {
 		return (p.id_ == id_ && p.priority_ == priority_ && p.read_request_id == read_request_id
-				&& p.pkt_size_ == pkt_size_
+				&& p.pkt_size_ == pkt_size_ && p.label_id_ == label_id_
+				&& p.coherence_ == coherence_
 				&& (p.source_.first == source_.first
 						&& p.source_.second == source_.second)
 				&& (p.rd_wr_ == rd_wr_ && p.requestedSize_ == requestedSize_
@@ -169,6 +196,8 @@ public:
 		delivery_time_no_contention_ = p.delivery_time_no_contention_;
 		delivery_time_ = p.delivery_time_;
 		pkt_size_ = p.pkt_size_;
+		label_id_ = p.label_id_;
+		coherence_ = p.coherence_;
 
 		rd_wr_ = p.rd_wr_;
 		requestedSize_ = p.requestedSize_;
@@ -208,9 +237,9 @@ protected:
 	// empty
 
 private:
-	unsigned int id_;
+	uint64_t id_;
 	unsigned int priority_;
-	int read_request_id;
+	int64_t read_request_id; // -1 for packets not belonging to a read
 	pair<unsigned int, unsigned int> source_;
 	pair<unsigned int, unsigned int> destination_;
 	sc_time injection_time_;
@@ -223,8 +252,10 @@ private:
 
 	int write_rq_ID_;
 	int write_rq_size_;
-	int write_request_ID_;
+	int64_t write_request_ID_;
 	int pkt_size_;
+	int label_id_ = -1;
+	CoherenceKind coherence_ = NO_COHERENCE;
 
 };
 
@@ -15,6 +15,18 @@ using namespace std;
 
 void XBAR::process() {
 	while (true) {
+		nbActivations++;
+
+		// Suspended while the functional model forwards the packets.
+		// Back to cycle-accurate, the arbitration only resumes on the
+		// clock edge after the delivery of the packets the functional
+		// model took, so that they reach their outputs before newer ones
+		if (functional || !functionalPackets.empty()) {
+			wait(accurate_event);
+			nbActivations++;
+			wait();
+			continue;
+		}
 		if (policy == "Full") { // full
 			Packet pck;
 			for (size_t i = 0; i < params.getDimension(); i++) {
@@ -25,6 +37,8 @@ void XBAR::process() {
 						pck.set_delivery_time();
 						xb_outputs.at(destActual).write(pck);
 						TotalPacketExchanged++;
+					} else if (pck.isWrite()) {
+						nbDroppedWrites++;
 					}
 				}
 			}
@@ -42,6 +56,8 @@ void XBAR::process() {
 						last_ = current;
 						TotalPacketExchanged++;
 						break;
+					} else if (pck.isWrite()) {
+						nbDroppedWrites++;
 					}
 				}
 			}
@@ -71,6 +87,8 @@ void XBAR::process() {
 					rPck.set_delivery_time();
 					xb_outputs.at(destActual).write(rPck);
 					TotalPacketExchanged++;
+				} else if (rPck.isWrite()) {
+					nbDroppedWrites++;
 				}
 			}
 		}
@@ -78,6 +96,81 @@ void XBAR::process() {
 	}
 }
 
+/**
+ * Functional model: the packets written in the inputs are delivered
+ * after a fixed latency, without arbitration between the inputs. A
+ * packet whose output is full stays in flight and is retried on the
+ * next cycle. Once switched back to cycle-accurate, the packets still
+ * in flight are delivered here before the inputs are arbitrated again.
+ */
+void XBAR::functional_method() {
+	nbActivations++;
+	sc_time now = sc_time_stamp();
+	deque<Packet> blocked;
+	while (!functionalPackets.empty()
+			&& functionalPackets.front().first <= now) {
+		Packet &pck = functionalPackets.front().second;
+		int destActual = ComputeActualDestination(pck.get_destination(),
+				params);
+		if (xb_outputs.at(destActual).num_free() > 0) {
+			pck.set_delivery_time();
+			xb_outputs.at(destActual).write(pck);
+			TotalPacketExchanged++;
+			nbFunctionalPackets++;
+		} else {
+			blocked.push_back(pck);
+		}
+		functionalPackets.pop_front();
+	}
+	for (deque<Packet>::reverse_iterator it = blocked.rbegin();
+			it != blocked.rend(); ++it) {
+		functionalPackets.push_front(make_pair(now, *it));
+	}
+
+	// Take one packet per input in turn while there is room in flight,
+	// the packets left in the inputs hold back the senders
+	bool taken = functional;
+	while (taken && functionalPackets.size() < functionalCapacity) {
+		taken = false;
+		Packet pck;
+		for (size_t i = 0; i < params.getDimension()
+						&& functionalPackets.size() < functionalCapacity; i++) {
+			if (xb_inputs.at(i).nb_read(pck)) {
+				functionalPackets.push_back(
+						make_pair(now + functionalLatency, pck));
+				taken = true;
+			}
+		}
+	}
+
+	if (!functional && functionalPackets.empty()) {
+		accurate_event.notify(SC_ZERO_TIME);
+	} else if (!blocked.empty()) {
+		functional_event.notify(params.getCoresPeriodInNano(), SC_NS);
+	} else if (!functionalPackets.empty()) {
+		functional_event.notify(functionalPackets.front().first - now);
+	}
+}
+
+/**
+ * Packets waiting in the inputs when switching to the functional model
+ * are taken by it as room allows. When switching back to cycle-accurate,
+ * the functional model only delivers the packets it already took and the
+ * arbitration starts on the first clock edge after the last of them, so
+ * no packet is dropped, delivered twice or reordered by the switch.
+ */
+void XBAR::setFunctional(bool functional_) {
+	if (functional_ == functional) {
+		return;
+	}
+	functional = functional_;
+	if (functional) {
+		functional_event.notify(SC_ZERO_TIME);
+	} else if (functionalPackets.empty()) {
+		accurate_event.notify(SC_ZERO_TIME);
+	}
+}
+
 int XBAR::ComputeActualDestination(pair<unsigned int, unsigned int> dest,
 		dcSimuParams params) {
 	int Actual;
@@ -11,7 +11,9 @@
 #include "packet.hxx"
 #include <systemc.h>
 #include "../dcSimuParams.hxx"
+#include "../dcConfiguration.hxx"
 #include "lib/xbar_sc_fifo_ports.h"
+#include <deque>
 #include <iostream>
 
 namespace dreamcloud {
@@ -28,19 +30,54 @@ SC_MODULE(XBAR) {
 	dcSimuParams params;
 	unsigned last_;
 	int TotalPacketExchanged;
+	unsigned long int nbDroppedWrites; // write packets lost on a full output
+	unsigned long int nbActivations;
 	std::string policy;
 
+	// With the functional fidelity, packets are forwarded without
+	// arbitration after FUNCTIONAL_XBAR_LATENCY_IN_CYCLES and wait for
+	// room in a full output instead of being dropped. At most one packet
+	// per input and cycle of latency is in flight, the others wait in
+	// the inputs. The clocked process sleeps on accurate_event meanwhile.
+	bool functional;
+	unsigned long int nbFunctionalPackets;
+	sc_time functionalLatency;
+	std::deque<std::pair<sc_time, Packet> > functionalPackets; // by delivery time
+	std::deque<std::pair<sc_time, Packet> >::size_type functionalCapacity;
+	sc_event functional_event;
+	sc_event accurate_event;
+
 	SC_HAS_PROCESS(XBAR);
 	XBAR(sc_module_name name, dcSimuParams params_) :
 			sc_module(name), xb_inputs("xb_inputs",
 					(params_.getRows() * params_.getCols())), xb_outputs(
 					"xb_outputs", (params_.getRows() * params_.getCols())), params(
-					params_), last_(0), TotalPacketExchanged(0), policy(
-					params_.getXbarPolicy()) {
-		SC_CTHREAD(process, clk);
-
+					params_), last_(0), TotalPacketExchanged(0), nbDroppedWrites(0), nbActivations(
+					0), policy(params_.getXbarPolicy()), functional(
+					params_.getXbarFidelity() != "accurate"), nbFunctionalPackets(
+					0), functionalLatency(
+					FUNCTIONAL_XBAR_LATENCY_IN_CYCLES
+							* params_.getCoresPeriodInNano(), SC_NS), functionalCapacity(
+					FUNCTIONAL_XBAR_LATENCY_IN_CYCLES
+							* params_.getRows() * params_.getCols()) {
+		SC_THREAD(process);
+		sensitive << clk.pos();
+		dont_initialize();
+		if (functional) {
+			SC_METHOD(functional_method);
+			for (size_t i = 0; i < xb_inputs.size(); i++) {
+				sensitive << xb_inputs[i].data_written();
+			}
+			sensitive << functional_event;
+			dont_initialize();
+		}
 	}
 	void process();
+	void functional_method();
+
+	// Switch between the functional and cycle-accurate models, packets
+	// in flight are kept (see xbar.cxx)
+	void setFunctional(bool functional_);
 	int ComputeActualDestination(std::pair<unsigned int, unsigned int> dest,
 			dcSimuParams params);
 	int GetTotalPacketExchanged();